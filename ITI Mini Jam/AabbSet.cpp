@@ -0,0 +1,120 @@
+#include "AabbSet.h"
+
+#include <bit>
+#include <cfloat>
+
+#if defined(__AVX2__)
+#define AABB_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AABB_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace sf;
+using namespace std;
+
+void AabbSet::clear()
+{
+    count = 0;
+    minX.clear(); minY.clear(); maxX.clear(); maxY.clear();
+}
+
+void AabbSet::reserve(int boxes)
+{
+    size_t padded = static_cast<size_t>((boxes + LANES - 1) / LANES) * LANES;
+    minX.reserve(padded); minY.reserve(padded); maxX.reserve(padded); maxY.reserve(padded);
+}
+
+int AabbSet::add(const FloatRect& box)
+{
+    if (count % LANES == 0) {
+        // a new block of boxes that are empty and inside out, so they never overlap
+        size_t padded = static_cast<size_t>(count) + LANES;
+        minX.resize(padded, FLT_MAX); minY.resize(padded, FLT_MAX);
+        maxX.resize(padded, -FLT_MAX); maxY.resize(padded, -FLT_MAX);
+    }
+    set(count, box);
+    return count++;
+}
+
+void AabbSet::set(int index, const FloatRect& box)
+{
+    minX[index] = box.left;
+    minY[index] = box.top;
+    maxX[index] = box.left + box.width;
+    maxY[index] = box.top + box.height;
+}
+
+uint32_t AabbSet::testBlock(const float* minX, const float* minY, const float* maxX, const float* maxY, size_t i,
+    float qMinX, float qMinY, float qMaxX, float qMaxY)
+{
+#if defined(AABB_AVX2)
+    const __m256 qx0 = _mm256_set1_ps(qMinX), qy0 = _mm256_set1_ps(qMinY);
+    const __m256 qx1 = _mm256_set1_ps(qMaxX), qy1 = _mm256_set1_ps(qMaxY);
+    __m256 hit = _mm256_and_ps(
+        _mm256_and_ps(_mm256_cmp_ps(qx0, _mm256_loadu_ps(maxX + i), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_loadu_ps(minX + i), qx1, _CMP_LT_OQ)),
+        _mm256_and_ps(_mm256_cmp_ps(qy0, _mm256_loadu_ps(maxY + i), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_loadu_ps(minY + i), qy1, _CMP_LT_OQ)));
+    return static_cast<uint32_t>(_mm256_movemask_ps(hit));
+#elif defined(AABB_SSE2)
+    const __m128 qx0 = _mm_set1_ps(qMinX), qy0 = _mm_set1_ps(qMinY);
+    const __m128 qx1 = _mm_set1_ps(qMaxX), qy1 = _mm_set1_ps(qMaxY);
+    uint32_t bits = 0;
+    for (int half = 0; half < LANES; half += 4) {
+        size_t j = i + half;
+        __m128 hit = _mm_and_ps(
+            _mm_and_ps(_mm_cmplt_ps(qx0, _mm_loadu_ps(maxX + j)), _mm_cmplt_ps(_mm_loadu_ps(minX + j), qx1)),
+            _mm_and_ps(_mm_cmplt_ps(qy0, _mm_loadu_ps(maxY + j)), _mm_cmplt_ps(_mm_loadu_ps(minY + j), qy1)));
+        bits |= static_cast<uint32_t>(_mm_movemask_ps(hit)) << half;
+    }
+    return bits;
+#else
+    uint32_t bits = 0;
+    for (int k = 0; k < LANES; k++) {
+        size_t j = i + k;
+        bool hit = (qMinX < maxX[j]) & (minX[j] < qMaxX) & (qMinY < maxY[j]) & (minY[j] < qMaxY);
+        bits |= static_cast<uint32_t>(hit) << k;
+    }
+    return bits;
+#endif
+}
+
+int AabbSet::query(const FloatRect& box, uint32_t* mask) const
+{
+    const float qMinX = box.left, qMinY = box.top;
+    const float qMaxX = box.left + box.width, qMaxY = box.top + box.height;
+
+    for (int w = 0; w < maskWords(); w++) mask[w] = 0;
+
+    int hits = 0;
+    for (size_t i = 0; i < static_cast<size_t>(count); i += LANES) {
+        uint32_t bits = testBlock(minX.data(), minY.data(), maxX.data(), maxY.data(), i, qMinX, qMinY, qMaxX, qMaxY);
+        if (!bits) continue;
+        mask[i / 32] |= bits << (i % 32);
+        hits += popcount(bits);
+    }
+    return hits;
+}
+
+int AabbSet::first(const FloatRect& box) const
+{
+    const float qMinX = box.left, qMinY = box.top;
+    const float qMaxX = box.left + box.width, qMaxY = box.top + box.height;
+
+    for (size_t i = 0; i < static_cast<size_t>(count); i += LANES) {
+        uint32_t bits = testBlock(minX.data(), minY.data(), maxX.data(), maxY.data(), i, qMinX, qMinY, qMaxX, qMaxY);
+        if (bits) return static_cast<int>(i) + countr_zero(bits);
+    }
+    return -1;
+}
+
+const char* AabbSet::kernelName()
+{
+#if defined(AABB_AVX2)
+    return "AVX2";
+#elif defined(AABB_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
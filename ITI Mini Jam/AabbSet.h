@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+// Axis-aligned boxes (hazards, triggers, pickups) kept as separate
+// min/max arrays so one query box can be tested against LANES of them per
+// instruction. Uses AVX2 when the build targets it, SSE2 otherwise (every
+// x86/x64 target), and plain C++ anywhere else. Overlap matches
+// FloatRect::intersects: touching edges don't count.
+class AabbSet {
+public:
+    static const int LANES = 8;     // arrays are padded to this with boxes that never hit
+
+    void clear();
+    void reserve(int boxes);
+    int add(const sf::FloatRect& box);      // returns the box's index
+    void set(int index, const sf::FloatRect& box);
+    int size() const { return count; }
+
+    // words needed for a query() mask, one bit per box
+    int maskWords() const { return (count + 31) / 32; }
+
+    // sets bit i of `mask` for every box i that overlaps `box`, returns how many did
+    int query(const sf::FloatRect& box, uint32_t* mask) const;
+    // index of the first overlapping box, -1 if none
+    int first(const sf::FloatRect& box) const;
+
+    static const char* kernelName();
+
+private:
+    // LANES-bit hit mask for boxes [i, i + LANES)
+    static uint32_t testBlock(const float* minX, const float* minY, const float* maxX, const float* maxY, size_t i,
+        float qMinX, float qMinY, float qMaxX, float qMaxY);
+
+    int count = 0;
+    std::vector<float> minX, minY, maxX, maxY;
+};
@@ -0,0 +1,94 @@
+#include "AnimationSystem.h"
+
+using namespace sf;
+using namespace std;
+
+void AnimationSystem::reserve(size_t entities)
+{
+    sprites.reserve(entities);
+    clips.reserve(entities);
+    frames.reserve(entities);
+    times.reserve(entities);
+    dirty.reserve(entities);
+}
+
+int AnimationSystem::addClip(const Texture& texture, int frameW, int frameH, int count, float frameDuration, bool loop)
+{
+    AnimClip clip = { &texture, static_cast<int>(frameRects.size()), count, loop };
+    for (int i = 0; i < count; i++) {
+        frameRects.emplace_back(i * frameW, 0, frameW, frameH);
+        frameDurations.push_back(frameDuration);
+    }
+    clipTable.push_back(clip);
+    return static_cast<int>(clipTable.size()) - 1;
+}
+
+int AnimationSystem::add(Sprite& sprite, int clip)
+{
+    sprites.push_back(&sprite);
+    clips.push_back(-1);
+    frames.push_back(0);
+    times.push_back(0.f);
+    dirty.push_back(1);
+
+    int entity = static_cast<int>(sprites.size()) - 1;
+    play(entity, clip);
+    return entity;
+}
+
+void AnimationSystem::play(int entity, int clip)
+{
+    if (clips[entity] == clip) return;
+    clips[entity] = clip;
+    sprites[entity]->setTexture(*clipTable[clip].texture);
+    restart(entity);
+}
+
+void AnimationSystem::restart(int entity)
+{
+    frames[entity] = 0;
+    times[entity] = 0.f;
+    dirty[entity] = 1;
+}
+
+void AnimationSystem::seek(int entity, int clip, int frame, float time)
+{
+    if (clips[entity] != clip) {
+        clips[entity] = clip;
+        sprites[entity]->setTexture(*clipTable[clip].texture);
+    }
+    frames[entity] = frame;
+    times[entity] = time;
+    dirty[entity] = 1;
+}
+
+void AnimationSystem::update(float dt)
+{
+    const size_t count = sprites.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        const AnimClip& clip = clipTable[clips[i]];
+        int frame = frames[i];
+        float t = times[i] + dt;
+        bool changed = dirty[i] != 0;
+
+        float duration = frameDurations[clip.firstFrame + frame];
+        while (t >= duration)
+        {
+            if (frame + 1 < clip.frameCount) frame++;
+            else if (clip.loop) frame = 0;
+            else { t = 0.f; break; }     // hold the last frame
+
+            t -= duration;
+            changed = true;
+            duration = frameDurations[clip.firstFrame + frame];
+        }
+
+        times[i] = t;
+        if (changed) {
+            frames[i] = frame;
+            dirty[i] = 0;
+            sprites[i]->setTextureRect(frameRects[clip.firstFrame + frame]);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// A clip is a run of frames in the shared frame table
+struct AnimClip {
+    const sf::Texture* texture;
+    int firstFrame;
+    int frameCount;
+    bool loop;
+};
+
+// Data-driven sprite animation advanced from the simulation dt. Clips are
+// tables of frame rects and durations; per-entity state is kept in flat
+// arrays so one pass updates every animated sprite, and a sprite's
+// texture rect is only rewritten when its frame actually changes.
+class AnimationSystem {
+public:
+    void reserve(size_t entities);
+
+    // clip of `frames` equally sized cells laid out left to right
+    int addClip(const sf::Texture& texture, int frameW, int frameH, int frames, float frameDuration, bool loop = true);
+
+    int add(sf::Sprite& sprite, int clip);
+    // switches clip and restarts it, no-op if it is already playing
+    void play(int entity, int clip);
+    void restart(int entity);
+    // jumps straight to a saved state (restores, rewinds)
+    void seek(int entity, int clip, int frame, float time);
+
+    void update(float dt);
+
+    int clipOf(int entity) const { return clips[entity]; }
+    int frameOf(int entity) const { return frames[entity]; }
+    float timeOf(int entity) const { return times[entity]; }
+    const sf::IntRect& rectOf(int entity) const { return frameRects[clipTable[clips[entity]].firstFrame + frames[entity]]; }
+
+private:
+    // clip data
+    std::vector<AnimClip> clipTable;
+    std::vector<sf::IntRect> frameRects;
+    std::vector<float> frameDurations;
+
+    // entity data
+    std::vector<sf::Sprite*> sprites;
+    std::vector<int> clips;
+    std::vector<int> frames;
+    std::vector<float> times;
+    std::vector<unsigned char> dirty;
+};
@@ -0,0 +1,459 @@
+#include "AssetPack.h"
+
+#include "StartupProfile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    const char* mapped = nullptr;
+    unordered_map<string, const AssetPack::Entry*> packIndex;
+
+    // sounds bigger than this stay encoded and are streamed by sf::Music
+    const uintmax_t STREAM_THRESHOLD = 1024 * 1024;
+
+    string lower(string s)
+    {
+        transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        return s;
+    }
+
+    bool readFile(const string& path, vector<char>& out)
+    {
+        ifstream in(path, ios::binary);
+        if (!in) return false;
+        out.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        return true;
+    }
+
+    enum Kind { Unsupported, ImageFile, SoundFile, FontFile };
+
+    Kind kindOf(const string& path)
+    {
+        string ext = lower(std::filesystem::path(path).extension().string());
+        if (ext == ".png" || ext == ".jpg" || ext == ".bmp" || ext == ".tga") return ImageFile;
+        if (ext == ".wav" || ext == ".ogg" || ext == ".flac" || ext == ".mp3") return SoundFile;
+        if (ext == ".ttf" || ext == ".otf") return FontFile;
+        return Unsupported;
+    }
+
+    // decodes a loose file the way the pack stores it: images to RGBA,
+    // sounds to 16-bit PCM, anything else as its bytes
+    bool decodeImage(const string& path, AssetPack::Entry& entry, vector<char>& bytes)
+    {
+        sf::Image img;
+        if (!img.loadFromFile(path)) return false;
+        entry.type = AssetPack::Image;
+        entry.a = img.getSize().x;
+        entry.b = img.getSize().y;
+        const char* px = reinterpret_cast<const char*>(img.getPixelsPtr());
+        bytes.assign(px, px + static_cast<size_t>(entry.a) * entry.b * 4);
+        return true;
+    }
+
+    bool decodeSound(const string& path, AssetPack::Entry& entry, vector<char>& bytes)
+    {
+        InputSoundFile in;
+        if (!in.openFromFile(path)) return false;
+        entry.type = AssetPack::Sound;
+        entry.a = in.getChannelCount();
+        entry.b = in.getSampleRate();
+        bytes.resize(static_cast<size_t>(in.getSampleCount()) * sizeof(Int16));
+        Uint64 got = in.read(reinterpret_cast<Int16*>(bytes.data()), in.getSampleCount());
+        bytes.resize(static_cast<size_t>(got) * sizeof(Int16));
+        return true;
+    }
+
+    // ---- preload: decode cache filled by loader threads ----
+
+    struct Decoded {
+        enum State { Pending, Ready, Failed, Taken };
+        string path;
+        AssetPack::Entry entry{};
+        vector<char> bytes;
+        State state = Pending;
+    };
+
+    unordered_map<string, unique_ptr<Decoded>> decodeCache;
+    vector<Decoded*> decodeQueue;   // guarded by decodeLock like the states
+    size_t nextDecode = 0;
+    vector<thread> loaders;
+    mutex decodeLock;
+    condition_variable decodeDone;
+
+    void runLoader(int id)
+    {
+        for (;;)
+        {
+            Decoded* next;
+            {
+                lock_guard<mutex> guard(decodeLock);
+                if (nextDecode == decodeQueue.size()) return;
+                next = decodeQueue[nextDecode++];
+            }
+            Decoded& d = *next;
+            double begin = StartupProfile::now();
+            vector<char> bytes;
+            AssetPack::Entry entry{};
+            bool ok = false;
+            switch (kindOf(d.path)) {
+            case ImageFile: ok = decodeImage(d.path, entry, bytes); break;
+            case SoundFile: ok = decodeSound(d.path, entry, bytes); break;
+            case FontFile: entry.type = AssetPack::Raw; ok = readFile(d.path, bytes); break;
+            default: break;     // unsupported, the load falls back to the file
+            }
+            StartupProfile::record(d.path, StartupProfile::Decode, begin, StartupProfile::now(), id);
+
+            lock_guard<mutex> guard(decodeLock);
+            d.entry = entry;
+            d.bytes = move(bytes);
+            d.state = ok ? Decoded::Ready : Decoded::Failed;
+            decodeDone.notify_all();
+        }
+    }
+
+    // the preloaded decode of `path`, waiting for it if a loader is still
+    // on it; nullptr if it wasn't preloaded (or was already used)
+    Decoded* takeDecoded(const string& path)
+    {
+        unique_lock<mutex> lock(decodeLock);
+        auto it = decodeCache.find(path);
+        if (it == decodeCache.end() || it->second->state == Decoded::Taken) return nullptr;
+
+        Decoded* d = it->second.get();
+        if (d->state == Decoded::Pending) {
+            double begin = StartupProfile::now();
+            decodeDone.wait(lock, [d] { return d->state != Decoded::Pending; });
+            StartupProfile::record(path, StartupProfile::Wait, begin, StartupProfile::now());
+        }
+        return d;
+    }
+
+    // pixels and samples are copied by the upload (fonts take their bytes instead)
+    void releaseDecoded(Decoded* d)
+    {
+        lock_guard<mutex> guard(decodeLock);
+        d->state = Decoded::Taken;
+        vector<char>().swap(d->bytes);
+    }
+
+    const void* mapFile(const string& path, size_t& size)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return nullptr;
+        LARGE_INTEGER len;
+        GetFileSizeEx(file, &len);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return nullptr;
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);   // the view keeps the mapping alive
+        size = static_cast<size_t>(len.QuadPart);
+        return view;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st;
+        fstat(fd, &st);
+        void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return nullptr;
+        size = static_cast<size_t>(st.st_size);
+        return view;
+#endif
+    }
+
+    void unmapFile(const void* view, size_t size)
+    {
+#ifdef _WIN32
+        (void)size;
+        UnmapViewOfFile(view);
+#else
+        munmap(const_cast<void*>(view), size);
+#endif
+    }
+}
+
+bool AssetPack::build(const string& root, const string& packPath)
+{
+    namespace fs = std::filesystem;
+
+    struct Item { Entry entry; vector<char> bytes; };
+    vector<Item> items;
+
+    error_code ec;
+    for (auto& f : fs::recursive_directory_iterator(root, ec))
+    {
+        if (!f.is_regular_file()) continue;
+        string path = f.path().generic_string();
+        Kind kind = kindOf(path);
+
+        Item item{};
+        if (path.size() >= sizeof(item.entry.path)) {
+            cerr << "Warning: pack path too long, skipped: " << path << "\n";
+            continue;
+        }
+        memcpy(item.entry.path, path.c_str(), path.size());
+
+        if (kind == ImageFile) {
+            if (!decodeImage(path, item.entry, item.bytes)) { cerr << "Warning: can't decode " << path << "\n"; continue; }
+            if (path.rfind(MASK_DIR, 0) == 0 && path.size() + 5 < sizeof(item.entry.path)) {
+                sf::Image img;
+                img.create(item.entry.a, item.entry.b, reinterpret_cast<const Uint8*>(item.bytes.data()));
+                CollisionMask mask;
+                mask.build(img);
+
+                Item maskItem{};
+                memcpy(maskItem.entry.path, (path + ".mask").c_str(), path.size() + 5);
+                maskItem.entry.type = Mask;
+                maskItem.entry.a = item.entry.a;
+                maskItem.entry.b = item.entry.b;
+                mask.serialize(maskItem.bytes);
+                items.push_back(move(maskItem));
+            }
+        }
+        else if (kind == SoundFile && f.file_size() <= STREAM_THRESHOLD) {
+            if (!decodeSound(path, item.entry, item.bytes)) { cerr << "Warning: can't decode " << path << "\n"; continue; }
+        }
+        else if (kind == SoundFile || kind == FontFile) {
+            item.entry.type = Raw;
+            if (!readFile(path, item.bytes)) { cerr << "Warning: can't read " << path << "\n"; continue; }
+        }
+        else {
+            cerr << "Pack: skipping unsupported " << path << "\n";
+            continue;
+        }
+        items.push_back(move(item));
+    }
+    if (ec) {
+        cerr << "Error: can't scan " << root << ": " << ec.message() << "\n";
+        return false;
+    }
+
+    sort(items.begin(), items.end(), [](const Item& x, const Item& y) { return strcmp(x.entry.path, y.entry.path) < 0; });
+
+    // data blocks are 16-byte aligned so samples/pixels can be used in place
+    uint64_t offset = sizeof(Header) + sizeof(Entry) * items.size();
+    for (auto& item : items) {
+        offset = (offset + 15) & ~uint64_t(15);
+        item.entry.offset = offset;
+        item.entry.size = item.bytes.size();
+        offset += item.entry.size;
+    }
+
+    ofstream out(packPath, ios::binary);
+    if (!out) {
+        cerr << "Error: can't write " << packPath << "\n";
+        return false;
+    }
+
+    Header header = { { 'E', 'S', 'C', 'P' }, VERSION, static_cast<uint32_t>(items.size()), 0 };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto& item : items)
+        out.write(reinterpret_cast<const char*>(&item.entry), sizeof(Entry));
+
+    uint64_t pos = sizeof(Header) + sizeof(Entry) * items.size();
+    const char zeros[16] = {};
+    for (auto& item : items) {
+        out.write(zeros, static_cast<streamsize>(item.entry.offset - pos));
+        out.write(item.bytes.data(), static_cast<streamsize>(item.bytes.size()));
+        pos = item.entry.offset + item.entry.size;
+    }
+
+    cerr << "Packed " << items.size() << " assets into " << packPath << " (" << pos / 1024 << " KB)\n";
+    return static_cast<bool>(out);
+}
+
+bool AssetPack::open(const string& packPath)
+{
+    size_t size = 0;
+    const char* view = static_cast<const char*>(mapFile(packPath, size));
+    if (!view) return false;
+
+    const Header* header = reinterpret_cast<const Header*>(view);
+    if (size < sizeof(Header) || memcmp(header->magic, "ESCP", 4) != 0 || header->version != VERSION ||
+        size < sizeof(Header) + sizeof(Entry) * header->entryCount) {
+        cerr << "Warning: " << packPath << " is not a valid asset pack, using loose files\n";
+        unmapFile(view, size);
+        return false;
+    }
+
+    const Entry* entries = reinterpret_cast<const Entry*>(view + sizeof(Header));
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        if (entries[i].offset + entries[i].size > size) continue;
+        packIndex[string(entries[i].path, strnlen(entries[i].path, sizeof(entries[i].path)))] = &entries[i];
+    }
+
+    mapped = view;
+    return true;
+}
+
+bool AssetPack::isOpen()
+{
+    return mapped != nullptr;
+}
+
+const AssetPack::Entry* AssetPack::find(const string& path)
+{
+    auto it = packIndex.find(path);
+    return it == packIndex.end() ? nullptr : it->second;
+}
+
+const void* AssetPack::data(const Entry& e)
+{
+    return mapped + e.offset;
+}
+
+bool AssetPack::loadTexture(Texture& tex, const string& path)
+{
+    if (!mapped) {
+        if (Decoded* d = takeDecoded(path); d && d->state == Decoded::Ready) {
+            StartupScope scope(path.c_str(), StartupProfile::Upload);
+            bool ok = tex.create(d->entry.a, d->entry.b);
+            if (ok) tex.update(reinterpret_cast<const Uint8*>(d->bytes.data()));
+            releaseDecoded(d);
+            return ok;
+        }
+        StartupScope scope(path.c_str(), StartupProfile::Load);
+        return tex.loadFromFile(path);
+    }
+
+    StartupScope scope(path.c_str(), StartupProfile::Upload);
+    const Entry* e = find(path);
+    if (!e || e->type != Image || !tex.create(e->a, e->b)) return false;
+    tex.update(static_cast<const Uint8*>(data(*e)));
+    return true;
+}
+
+bool AssetPack::loadSoundBuffer(SoundBuffer& buf, const string& path)
+{
+    if (!mapped) {
+        if (Decoded* d = takeDecoded(path); d && d->state == Decoded::Ready) {
+            StartupScope scope(path.c_str(), StartupProfile::Upload);
+            bool ok = buf.loadFromSamples(reinterpret_cast<const Int16*>(d->bytes.data()), d->bytes.size() / sizeof(Int16), d->entry.a, d->entry.b);
+            releaseDecoded(d);
+            return ok;
+        }
+        StartupScope scope(path.c_str(), StartupProfile::Load);
+        return buf.loadFromFile(path);
+    }
+
+    StartupScope scope(path.c_str(), StartupProfile::Upload);
+    const Entry* e = find(path);
+    if (!e || e->type != Sound) return false;
+    return buf.loadFromSamples(static_cast<const Int16*>(data(*e)), e->size / sizeof(Int16), e->a, e->b);
+}
+
+bool AssetPack::loadFont(Font& font, const string& path, vector<char>& bytes)
+{
+    if (!mapped) {
+        if (Decoded* d = takeDecoded(path); d && d->state == Decoded::Ready) {
+            StartupScope scope(path.c_str(), StartupProfile::Upload);
+            {
+                lock_guard<mutex> guard(decodeLock);
+                bytes = move(d->bytes);
+                d->state = Decoded::Taken;
+            }
+            return font.loadFromMemory(bytes.data(), bytes.size());
+        }
+        StartupScope scope(path.c_str(), StartupProfile::Load);
+        return font.loadFromFile(path);
+    }
+
+    StartupScope scope(path.c_str(), StartupProfile::Upload);
+    const Entry* e = find(path);
+    if (!e || e->type != Raw) return false;
+    return font.loadFromMemory(data(*e), static_cast<size_t>(e->size));
+}
+
+bool AssetPack::loadMask(CollisionMask& mask, const string& imagePath)
+{
+    if (!mapped) {
+        sf::Image img;
+        if (!img.loadFromFile(imagePath)) return false;
+        mask.build(img);
+        return !mask.empty();
+    }
+
+    const Entry* e = find(imagePath + ".mask");
+    if (!e || e->type != Mask) return false;
+    return mask.load(data(*e), static_cast<size_t>(e->size));
+}
+
+bool AssetPack::openMusic(Music& music, const string& path)
+{
+    if (!mapped) return music.openFromFile(path);
+
+    const Entry* e = find(path);
+    if (!e || e->type != Raw) return false;
+    return music.openFromMemory(data(*e), static_cast<size_t>(e->size));
+}
+
+void AssetPack::preload(const vector<string>& paths, unsigned threads)
+{
+    // the pack is already decoded, there is nothing to get ahead on
+    if (mapped) return;
+
+    unsigned queued = 0;
+    {
+        lock_guard<mutex> guard(decodeLock);
+        if (nextDecode == decodeQueue.size()) {
+            decodeQueue.clear();
+            nextDecode = 0;
+        }
+        for (auto& path : paths) {
+            auto& d = decodeCache[path];
+            if (!d) {
+                d = make_unique<Decoded>();
+                d->path = path;
+            }
+            else if (d->state != Decoded::Taken) continue;  // already queued
+            d->state = Decoded::Pending;
+            decodeQueue.push_back(d.get());
+            queued++;
+        }
+    }
+
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency() - 1);
+    threads = min(threads, queued);
+    for (unsigned i = 0; i < threads; i++)
+        loaders.emplace_back(runLoader, static_cast<int>(loaders.size()) + 1);
+}
+
+void AssetPack::finishPreload()
+{
+    for (auto& t : loaders) t.join();
+    loaders.clear();
+
+    lock_guard<mutex> guard(decodeLock);
+    for (auto& [path, d] : decodeCache) {
+        if (d->state == Decoded::Taken) continue;
+        d->state = Decoded::Taken;
+        vector<char>().swap(d->bytes);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CollisionMask.h"
+
+// Single-file asset pack with everything pre-decoded: images as raw RGBA,
+// short sounds as 16-bit PCM, fonts and streamed music as their original
+// bytes. Hazard art (under MASK_DIR) also gets its collision mask, stored
+// as "<image path>.mask". The pack is memory-mapped and resources are created straight
+// from the mapped bytes.
+//
+// Every load goes through the functions below. With no pack open they
+// fall back to the loose files under Assets/. With a pack open, an asset
+// missing from the index fails without touching the disk.
+//
+// Without a pack, preload() decodes loose files on loader threads ahead
+// of time; a later load of the same path waits for its decode if needed
+// and only does the upload on the calling thread. It can be called again
+// for each scene transition.
+class AssetPack {
+public:
+    enum Type : uint32_t { Image = 1, Sound = 2, Raw = 3, Mask = 4 };
+
+    struct Header {
+        char magic[4];          // "ESCP"
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+    };
+
+    struct Entry {
+        char path[112];         // e.g. "Assets/Props/Tree.png"
+        uint32_t type;
+        uint32_t a, b;          // Image, Mask: width, height / Sound: channels, sample rate
+        uint32_t reserved;
+        uint64_t offset, size;  // data bytes from the start of the file
+    };
+
+    static const uint32_t VERSION = 2;
+    static constexpr const char* MASK_DIR = "Assets/Spikes/";
+
+    // build step: decodes everything under `root` into one pack file
+    static bool build(const std::string& root, const std::string& packPath);
+
+    // maps the pack for the rest of the process (fonts and music read from it lazily)
+    static bool open(const std::string& packPath);
+    static bool isOpen();
+
+    static bool loadTexture(sf::Texture& tex, const std::string& path);
+    static bool loadSoundBuffer(sf::SoundBuffer& buf, const std::string& path);
+    // sf::Font keeps reading the memory it was loaded from: a preloaded
+    // font's file moves into `bytes`, which has to outlive the font
+    static bool loadFont(sf::Font& font, const std::string& path, std::vector<char>& bytes);
+    static bool openMusic(sf::Music& music, const std::string& path);
+    // collision mask of an image; from the pack, or built from the file
+    static bool loadMask(CollisionMask& mask, const std::string& imagePath);
+
+    // starts decoding `paths` (images, sounds, fonts) on up to `threads`
+    // loader threads (0 = one per spare core); no-op with a pack open
+    static void preload(const std::vector<std::string>& paths, unsigned threads = 0);
+    // joins the loaders, call once the preloaded assets have been loaded;
+    // decodes nobody took are dropped
+    static void finishPreload();
+
+    // raw view of an entry, nullptr if the pack has no such asset
+    static const Entry* find(const std::string& path);
+    static const void* data(const Entry& e);
+};
@@ -0,0 +1,283 @@
+#include "BatchSim.h"
+
+#include "WorldState.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    const float TICK = 1.f / 60.f;
+    const float EMPTY = -1e9f;      // an empty slot is a point far off to the left
+    const float NEVER = 1e9f;       // jumpAge with no press buffered
+
+    void setSlot(vector<float>& l, vector<float>& t, vector<float>& r, vector<float>& b, size_t i, const FloatRect& rect)
+    {
+        l[i] = rect.left;
+        t[i] = rect.top;
+        r[i] = rect.left + rect.width;
+        b[i] = rect.top + rect.height;
+    }
+
+    void clearSlot(vector<float>& l, vector<float>& t, vector<float>& r, vector<float>& b, size_t i)
+    {
+        l[i] = t[i] = r[i] = b[i] = EMPTY;
+    }
+}
+
+BatchSim::BatchSim(int worlds, uint32_t seed)
+    : count(max(worlds, 1)), nextSeed(seed)
+{
+    x.resize(count); y.resize(count); velY.resize(count);
+    groundTimer.resize(count); onGround.resize(count); jumpAge.resize(count); endX.resize(count);
+    seeds.resize(count); ticks.resize(count); dones.resize(count);
+
+    size_t solids = static_cast<size_t>(SOLID_SLOTS) * count;
+    size_t obstacles = static_cast<size_t>(OBSTACLE_SLOTS) * count;
+    solidL.resize(solids); solidT.resize(solids); solidR.resize(solids); solidB.resize(solids);
+    obstL.resize(obstacles); obstT.resize(obstacles); obstR.resize(obstacles); obstB.resize(obstacles);
+
+    reset();
+}
+
+void BatchSim::reset()
+{
+    for (int w = 0; w < count; w++) {
+        resetWorld(w);
+        dones[w] = Running;
+    }
+}
+
+void BatchSim::resetWorld(int w)
+{
+    LevelLayout level;
+    LevelGenerator::generate(nextSeed, LevelGenerator::HEADLESS_WIDTH, LevelGenerator::HEADLESS_HEIGHT, level);
+    seeds[w] = nextSeed++;
+
+    PlayerBody body;
+    x[w] = body.x;
+    y[w] = body.y;
+    velY[w] = body.velY;
+    groundTimer[w] = body.groundTimer;
+    onGround[w] = body.onGround ? 1.f : 0.f;
+    jumpAge[w] = NEVER;
+    endX[w] = level.endX;
+    ticks[w] = 0;
+
+    setSlot(solidL, solidT, solidR, solidB, w, level.ground);
+    for (int i = 0; i < LevelLayout::MAX_PLATFORMS; i++) {
+        size_t slot = static_cast<size_t>(1 + i) * count + w;
+        if (i < level.platformCount) setSlot(solidL, solidT, solidR, solidB, slot, level.platforms[i]);
+        else clearSlot(solidL, solidT, solidR, solidB, slot);
+    }
+    for (int i = 0; i < LevelLayout::MAX_OBSTACLES; i++) {
+        size_t slot = static_cast<size_t>(i) * count + w;
+        if (i < level.obstacleCount) setSlot(obstL, obstT, obstR, obstB, slot, level.obstacles[i]);
+        else clearSlot(obstL, obstT, obstR, obstB, slot);
+    }
+
+    usedSolids = max(usedSolids, 1 + level.platformCount);
+    usedObstacles = max(usedObstacles, level.obstacleCount);
+}
+
+void BatchSim::step(const uint8_t* actions, float* obs)
+{
+    const PlayerTuning t = tuning;
+    float* px = x.data();
+    float* py = y.data();
+    float* pv = velY.data();
+    float* pt = groundTimer.data();
+    float* pg = onGround.data();
+    float* pj = jumpAge.data();
+
+    // movement, coyote time, jump buffer and gravity, as stepPlayer
+    for (int w = 0; w < count; w++)
+    {
+        float dir = ((actions[w] & Right) ? 1.f : 0.f) - ((actions[w] & Left) ? 1.f : 0.f);
+        px[w] += dir * t.speed;
+
+        float timer = pg[w] != 0.f ? t.coyoteTime : pt[w] - TICK;
+        float age = (actions[w] & Jump) ? 0.f : pj[w];
+        bool jumps = (timer > 0.f) & (age <= t.jumpBufferTime);
+
+        float vy = (jumps ? -t.jumpSpeed : pv[w]) + t.gravity;
+        pv[w] = vy;
+        py[w] += vy;
+        pt[w] = jumps ? 0.f : timer;
+        pj[w] = (jumps ? NEVER : age) + TICK;
+        pg[w] = 0.f;
+    }
+
+    // the inner loops below stay branch-free (& rather than &&, selects
+    // rather than ifs) so they vectorize across worlds
+    float hit[BLOCK];
+    for (int b = 0; b < count; b += BLOCK)
+    {
+        const int n = min(BLOCK, count - b);
+        float* bx = px + b;
+        float* by = py + b;
+        float* bv = pv + b;
+        float* bg = pg + b;
+
+        // push out of the ground and platforms in order, as resolveCollision
+        for (int s = 0; s < usedSolids; s++)
+        {
+            const size_t row = static_cast<size_t>(s) * count + b;
+            const float* L = solidL.data() + row;
+            const float* T = solidT.data() + row;
+            const float* R = solidR.data() + row;
+            const float* B = solidB.data() + row;
+            for (int i = 0; i < n; i++)
+            {
+                float hbL = bx[i] - t.originX, hbT = by[i] - t.originY;
+                float hbR = hbL + t.width, hbB = hbT + t.height;
+                bool overlap = (max(hbL, L[i]) < min(hbR, R[i])) & (max(hbT, T[i]) < min(hbB, B[i]));
+
+                float oL = hbR - L[i], oR = R[i] - hbL;
+                float oT = hbB - T[i], oB = B[i] - hbT;
+                bool alongX = min(oL, oR) < min(oT, oB);
+                bool pushX = overlap & alongX;
+                bool pushY = overlap & !alongX;
+
+                bx[i] += pushX ? (oL < oR ? -oL : oR) : 0.f;
+                by[i] += pushY ? (oT < oB ? -oT : oB) : 0.f;
+                bv[i] = pushY ? 0.f : bv[i];
+                bg[i] = pushY & (oT < oB) ? 1.f : bg[i];
+            }
+        }
+
+        // any obstacle overlap is a death
+        for (int i = 0; i < n; i++) hit[i] = 0.f;
+        for (int s = 0; s < usedObstacles; s++)
+        {
+            const size_t row = static_cast<size_t>(s) * count + b;
+            const float* L = obstL.data() + row;
+            const float* T = obstT.data() + row;
+            const float* R = obstR.data() + row;
+            const float* B = obstB.data() + row;
+            for (int i = 0; i < n; i++)
+            {
+                float hbL = bx[i] - t.originX, hbT = by[i] - t.originY;
+                float hbR = hbL + t.width, hbB = hbT + t.height;
+                bool overlap = (max(hbL, L[i]) < min(hbR, R[i])) & (max(hbT, T[i]) < min(hbB, B[i]));
+                hit[i] = overlap ? 1.f : hit[i];
+            }
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            int w = b + i;
+            ticks[w]++;
+            dones[w] = hit[i] != 0.f ? Died : (bx[i] >= endX[w] ? Finished : Running);
+        }
+    }
+
+    for (int w = 0; w < count; w++)
+        if (dones[w] != Running) resetWorld(w);
+
+    if (obs) observe(obs);
+}
+
+void BatchSim::observe(float* obs) const
+{
+    const PlayerTuning t = tuning;
+    const float spawnX = PlayerBody().x;
+    float obstDx[BLOCK], obstTop[BLOCK], platDx[BLOCK], platTop[BLOCK];
+
+    for (int b = 0; b < count; b += BLOCK)
+    {
+        const int n = min(BLOCK, count - b);
+        const float* bx = x.data() + b;
+        const float* by = y.data() + b;
+
+        for (int i = 0; i < n; i++) {
+            obstDx[i] = platDx[i] = NONE;
+            obstTop[i] = platTop[i] = 0.f;
+        }
+
+        // nearest obstacle not yet behind the player
+        for (int s = 0; s < usedObstacles; s++)
+        {
+            const size_t row = static_cast<size_t>(s) * count + b;
+            const float* L = obstL.data() + row;
+            const float* T = obstT.data() + row;
+            const float* R = obstR.data() + row;
+            for (int i = 0; i < n; i++)
+            {
+                float hbL = bx[i] - t.originX;
+                float feet = by[i] - t.originY + t.height;
+                float d = R[i] > hbL ? L[i] - (hbL + t.width) : NONE;
+                bool closer = d < obstDx[i];
+                obstTop[i] = closer ? T[i] - feet : obstTop[i];
+                obstDx[i] = closer ? d : obstDx[i];
+            }
+        }
+
+        // nearest platform above the feet, the ground (slot 0) never is
+        for (int s = 1; s < usedSolids; s++)
+        {
+            const size_t row = static_cast<size_t>(s) * count + b;
+            const float* L = solidL.data() + row;
+            const float* T = solidT.data() + row;
+            const float* R = solidR.data() + row;
+            for (int i = 0; i < n; i++)
+            {
+                float hbL = bx[i] - t.originX;
+                float feet = by[i] - t.originY + t.height;
+                float d = (R[i] > hbL) & (T[i] < feet - 1.f) ? L[i] - (hbL + t.width) : NONE;
+                bool closer = d < platDx[i];
+                platTop[i] = closer ? T[i] - feet : platTop[i];
+                platDx[i] = closer ? d : platDx[i];
+            }
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            int w = b + i;
+            float* o = obs + static_cast<size_t>(w) * OBS_SIZE;
+            o[0] = x[w] - spawnX;
+            o[1] = y[w];
+            o[2] = velY[w];
+            o[3] = onGround[w];
+            o[4] = obstDx[i];
+            o[5] = obstTop[i];
+            o[6] = platDx[i];
+            o[7] = platTop[i];
+        }
+    }
+}
+
+void BatchSim::benchmark(int worlds, float seconds)
+{
+    BatchSim sim(worlds, 1);
+    vector<uint8_t> actions(sim.size());
+    vector<float> obs(static_cast<size_t>(sim.size()) * OBS_SIZE);
+    Rng rng = Rng::seeded(12345);
+
+    long long steps = 0, died = 0, finished = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0.0;
+    while (elapsed < seconds)
+    {
+        for (int w = 0; w < sim.size(); w++)
+            actions[w] = Right | ((rng.next() & 15) == 0 ? Jump : 0);
+        sim.step(actions.data(), obs.data());
+        steps++;
+
+        for (int w = 0; w < sim.size(); w++) {
+            died += sim.done(w) == Died;
+            finished += sim.done(w) == Finished;
+        }
+        if ((steps & 15) == 0)
+            elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double worldTicks = static_cast<double>(steps) * sim.size();
+    cout << "Batch: " << sim.size() << " worlds x " << steps << " steps in " << elapsed << " s\n";
+    cout << "  " << worldTicks / elapsed << " world-ticks/s, " << steps / elapsed << " steps/s\n";
+    cout << "  episodes: " << died << " died, " << finished << " finished\n";
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "LevelGenerator.h"
+#include "PlayerPhysics.h"
+
+// Steps N independent worlds in lockstep for training and evaluating
+// agents. Same rules as PlayerPhysics (the game and the Playtester), but
+// laid out as structure-of-arrays: every player field and every level
+// rect slot is a flat array over worlds, and each pass is a branch-free
+// loop over worlds that the compiler can vectorize. Level rects are
+// stored [slot][world] so slot j of every world sits side by side.
+//
+// A world that dies or reaches the end of its level reports it in done()
+// for that step and is immediately restarted on a fresh seed, so the
+// observation written for it is the first one of its next episode.
+class BatchSim {
+public:
+    enum Action : uint8_t { Left = 1, Right = 2, Jump = 4 };
+    enum Done : uint8_t { Running = 0, Died = 1, Finished = 2 };
+
+    // floats written per world by step()/observe():
+    // distance from spawn, y, velY, onGround,
+    // next obstacle: dx to its left edge, its top relative to the feet,
+    // next raised platform: dx to its left edge, its top relative to the feet
+    // (dx is NONE when there is nothing ahead)
+    static const int OBS_SIZE = 8;
+    static constexpr float NONE = 1e6f;
+
+    BatchSim(int worlds, uint32_t seed);
+
+    int size() const { return count; }
+
+    // restarts every world, seeds continue from where they were
+    void reset();
+
+    // actions: one Action mask per world; obs: size() * OBS_SIZE floats
+    void step(const uint8_t* actions, float* obs);
+    void observe(float* obs) const;
+
+    uint8_t done(int world) const { return dones[world]; }
+    uint32_t seedOf(int world) const { return seeds[world]; }
+    int episodeTicks(int world) const { return ticks[world]; }
+
+    // steps `worlds` worlds with random actions for about `seconds` and
+    // prints world-ticks per second
+    static void benchmark(int worlds, float seconds);
+
+private:
+    static const int SOLID_SLOTS = 1 + LevelLayout::MAX_PLATFORMS;     // ground first, then platforms
+    static const int OBSTACLE_SLOTS = LevelLayout::MAX_OBSTACLES;
+    // worlds per pass, so a block's player arrays stay in L1 across slots
+    static const int BLOCK = 256;
+
+    void resetWorld(int w);
+
+    int count;
+    int usedSolids = 1, usedObstacles = 0;     // highest slot count of any world
+    uint32_t nextSeed;
+    PlayerTuning tuning;
+
+    // player, one entry per world
+    std::vector<float> x, y, velY, groundTimer, onGround, jumpAge, endX;
+    std::vector<uint32_t> seeds;
+    std::vector<int> ticks;
+    std::vector<uint8_t> dones;
+
+    // level rects, [slot * stride + world]; empty slots never overlap anything
+    std::vector<float> solidL, solidT, solidR, solidB;
+    std::vector<float> obstL, obstT, obstR, obstB;
+};
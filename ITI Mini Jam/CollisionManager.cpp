@@ -1,54 +1,22 @@
 #include "CollisionManager.h"
 
-#include <algorithm>
-
 using namespace sf;
 using namespace std;
 
-void CollisionManager::resolveWithPlatform(Player& player, const Platform& platform, float& playerVelY, bool& playerOnGround)
+void CollisionManager::resolveWithPlatform(PlayerBody& body, const PlayerTuning& tuning, const Platform& platform, float originX)
 {
-    FloatRect hb = player.getGlobalBounds();
-    FloatRect pb = platform.getBounds();
-
-    if (!hb.intersects(pb)) return;
-
-    float hbLeft = hb.left, hbRight = hb.left + hb.width;
-    float hbTop = hb.top, hbBottom = hb.top + hb.height;
-    float pbLeft = pb.left, pbRight = pb.left + pb.width;
-    float pbTop = pb.top, pbBottom = pb.top + pb.height;
-
-    float overlapLeft = hbRight - pbLeft;
-    float overlapRight = pbRight - hbLeft;
-    float overlapTop = hbBottom - pbTop;
-    float overlapBottom = pbBottom - hbTop;
-
-    float minOverlapX = min(overlapLeft, overlapRight);
-    float minOverlapY = min(overlapTop, overlapBottom);
-
-    if (minOverlapX < minOverlapY) {
-        if (overlapLeft < overlapRight)
-            player.move(-overlapLeft, 0);
-        else
-            player.move(overlapRight, 0);
-    }
-    else {
-        if (overlapTop < overlapBottom) {
-            player.move(0, -overlapTop);
-            playerVelY = 0;
-            playerOnGround = true;
-        }
-        else {
-            player.move(0, overlapBottom);
-            playerVelY = 0;
-        }
-    }
+    FloatRect bounds = platform.getBounds();
+    bounds.left -= originX;
+    resolveCollision(body, tuning, bounds);
 }
 
-void CollisionManager::resolveAll(Player& player, vector<Platform>& platforms, Platform& ground, float& velY, bool& onGround)
+void CollisionManager::resolveAll(PlayerBody& body, const PlayerTuning& tuning, const ObjectPool<Platform>& platforms, const Platform& ground,
+    const TileGrid* terrain, float originX)
 {
-    resolveWithPlatform(player, ground, velY, onGround);
+    body.onGround = false;
+    if (terrain) terrain->resolve(body, tuning);
+    resolveWithPlatform(body, tuning, ground, originX);
     for (auto& p : platforms)
-        resolveWithPlatform(player, p, velY, onGround);
+        resolveWithPlatform(body, tuning, p, originX);
 }
 
-
@@ -1,14 +1,17 @@
 #pragma once
 
+#include "LevelArena.h"
 #include "Platform.h"
-#include "Player.h"
-
-#include <vector>
+#include "PlayerPhysics.h"
+#include "TileGrid.h"
 
 class CollisionManager {
 public:
-    static void resolveWithPlatform(Player& player, const Platform& platform, float& playerVelY, bool& playerOnGround);
-    static void resolveAll(Player& player, std::vector<Platform>& platforms, Platform& ground, float& velY, bool& onGround);
+    // platforms are in level coordinates, the body is relative to `originX`
+    static void resolveWithPlatform(PlayerBody& body, const PlayerTuning& tuning, const Platform& platform, float originX = 0.f);
+    // clears onGround, then resolves against the terrain (if any, already
+    // relative to originX), the ground and every platform
+    static void resolveAll(PlayerBody& body, const PlayerTuning& tuning, const ObjectPool<Platform>& platforms, const Platform& ground,
+        const TileGrid* terrain = nullptr, float originX = 0.f);
 };
 
-
@@ -0,0 +1,149 @@
+#include "CollisionMask.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace sf;
+using namespace std;
+
+void CollisionMask::build(const Image& image)
+{
+    const int w = static_cast<int>(image.getSize().x);
+    const int h = static_cast<int>(image.getSize().y);
+    const Uint8* px = image.getPixelsPtr();
+
+    levelCount = 0;
+    storage.clear();
+    if (w == 0 || h == 0) return;
+
+    // lay out every level first, the bit pointers are set once storage stops growing
+    size_t offsets[MAX_LEVELS];
+    for (int l = 0; l < MAX_LEVELS; l++) {
+        int lw = (w + (1 << l) - 1) >> l;
+        int lh = (h + (1 << l) - 1) >> l;
+        if (l > 0 && (lw < 8 || lh < 8)) break;
+
+        Level& level = levelTable[levelCount++];
+        level.width = lw;
+        level.height = lh;
+        level.wordsPerRow = (lw + 63) / 64;
+        offsets[l] = storage.size();
+        storage.resize(storage.size() + static_cast<size_t>(level.wordsPerRow) * lh, 0);
+    }
+
+    for (int l = 0; l < levelCount; l++) {
+        Level& level = levelTable[l];
+        uint64_t* bits = storage.data() + offsets[l];
+        const int cell = 1 << l;
+
+        for (int y = 0; y < level.height; y++) {
+            for (int x = 0; x < level.width; x++) {
+                int opaque = 0, total = 0;
+                for (int sy = y * cell; sy < min(h, (y + 1) * cell); sy++)
+                    for (int sx = x * cell; sx < min(w, (x + 1) * cell); sx++) {
+                        opaque += px[(static_cast<size_t>(sy) * w + sx) * 4 + 3] >= ALPHA_THRESHOLD;
+                        total++;
+                    }
+                if (opaque * 2 >= total)
+                    bits[y * level.wordsPerRow + (x >> 6)] |= uint64_t(1) << (x & 63);
+            }
+        }
+    }
+    for (int l = 0; l < levelCount; l++)
+        levelTable[l].bits = storage.data() + offsets[l];
+}
+
+void CollisionMask::serialize(vector<char>& out) const
+{
+    uint32_t count = static_cast<uint32_t>(levelCount);
+    LevelHeader headers[MAX_LEVELS] = {};
+    size_t words = 0;
+    for (int l = 0; l < levelCount; l++) {
+        const Level& level = levelTable[l];
+        headers[l] = { static_cast<uint32_t>(level.width), static_cast<uint32_t>(level.height),
+            static_cast<uint32_t>(level.wordsPerRow), static_cast<uint32_t>(words) };
+        words += static_cast<size_t>(level.wordsPerRow) * level.height;
+    }
+
+    // the rows start 8-byte aligned, the header part is padded to 16 bytes
+    size_t headerBytes = (sizeof(count) + sizeof(LevelHeader) * levelCount + 15) & ~size_t(15);
+    out.assign(headerBytes + words * sizeof(uint64_t), 0);
+    memcpy(out.data(), &count, sizeof(count));
+    memcpy(out.data() + sizeof(count), headers, sizeof(LevelHeader) * levelCount);
+    for (int l = 0; l < levelCount; l++) {
+        const Level& level = levelTable[l];
+        memcpy(out.data() + headerBytes + headers[l].offset * sizeof(uint64_t), level.bits,
+            static_cast<size_t>(level.wordsPerRow) * level.height * sizeof(uint64_t));
+    }
+}
+
+bool CollisionMask::load(const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    levelCount = 0;
+    storage.clear();
+
+    uint32_t count;
+    if (size < sizeof(count)) return false;
+    memcpy(&count, bytes, sizeof(count));
+    if (count == 0 || count > MAX_LEVELS) return false;
+
+    size_t headerBytes = (sizeof(count) + sizeof(LevelHeader) * count + 15) & ~size_t(15);
+    if (size < headerBytes) return false;
+
+    for (uint32_t l = 0; l < count; l++) {
+        LevelHeader hdr;
+        memcpy(&hdr, bytes + sizeof(count) + sizeof(LevelHeader) * l, sizeof(hdr));
+        size_t end = headerBytes + (static_cast<size_t>(hdr.offset) + static_cast<size_t>(hdr.wordsPerRow) * hdr.height) * sizeof(uint64_t);
+        if (end > size || hdr.wordsPerRow * 64 < hdr.width) return false;
+
+        Level& level = levelTable[l];
+        level.width = static_cast<int>(hdr.width);
+        level.height = static_cast<int>(hdr.height);
+        level.wordsPerRow = static_cast<int>(hdr.wordsPerRow);
+        level.bits = reinterpret_cast<const uint64_t*>(bytes + headerBytes) + hdr.offset;
+    }
+    levelCount = static_cast<int>(count);
+    return true;
+}
+
+int CollisionMask::levelFor(float w, float h) const
+{
+    int best = 0;
+    for (int l = 1; l < levelCount; l++)
+        if (levelTable[l].width >= w && levelTable[l].height >= h) best = l;
+    return best;
+}
+
+bool CollisionMask::overlaps(const FloatRect& box, const FloatRect& placed, int l) const
+{
+    if (levelCount == 0 || placed.width <= 0.f || placed.height <= 0.f) return false;
+    const Level& level = levelTable[min(l, levelCount - 1)];
+
+    // the box in cells, clamped to the mask; a partly covered cell counts
+    float sx = level.width / placed.width, sy = level.height / placed.height;
+    int x0 = max(0, static_cast<int>(floor((box.left - placed.left) * sx)));
+    int x1 = min(level.width, static_cast<int>(ceil((box.left + box.width - placed.left) * sx)));
+    int y0 = max(0, static_cast<int>(floor((box.top - placed.top) * sy)));
+    int y1 = min(level.height, static_cast<int>(ceil((box.top + box.height - placed.top) * sy)));
+    if (x0 >= x1 || y0 >= y1) return false;
+
+    // the box's columns as one mask per word, then AND each row with them
+    const int w0 = x0 >> 6, w1 = (x1 - 1) >> 6;
+    const uint64_t first = ~uint64_t(0) << (x0 & 63);
+    const uint64_t last = ~uint64_t(0) >> (63 - ((x1 - 1) & 63));
+
+    for (int y = y0; y < y1; y++) {
+        const uint64_t* row = level.bits + static_cast<size_t>(y) * level.wordsPerRow;
+        if (w0 == w1) {
+            if (row[w0] & first & last) return true;
+            continue;
+        }
+        if (row[w0] & first) return true;
+        for (int w = w0 + 1; w < w1; w++)
+            if (row[w]) return true;
+        if (row[w1] & last) return true;
+    }
+    return false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-pixel hazard shape from a sprite's alpha: 1 bit per pixel packed
+// into 64-bit words row by row, at MAX_LEVELS resolutions, each half the
+// previous one. A hazard picks the coarsest level that still has a cell
+// per drawn pixel, and a test against a box ANDs whole words of each row
+// it covers, so after the AABB test it costs a handful of word ops.
+//
+// The asset pack stores masks pre-built (see AssetPack::loadMask); the
+// serialized form is used in place from the mapped pack.
+class CollisionMask {
+public:
+    static const int MAX_LEVELS = 4;
+    static const uint8_t ALPHA_THRESHOLD = 128;
+
+    struct Level {
+        int width = 0, height = 0;
+        int wordsPerRow = 0;
+        const uint64_t* bits = nullptr;
+
+        bool test(int x, int y) const { return (bits[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1; }
+    };
+
+    CollisionMask() = default;
+    CollisionMask(const CollisionMask&) = delete;   // levels point into storage
+    CollisionMask& operator=(const CollisionMask&) = delete;
+
+    // a cell is solid if at least half of the pixels it covers are opaque
+    void build(const sf::Image& image);
+
+    void serialize(std::vector<char>& out) const;
+    // reads a serialized mask without copying, `data` has to outlive it
+    bool load(const void* data, size_t size);
+
+    bool empty() const { return levelCount == 0; }
+    int levels() const { return levelCount; }
+    const Level& level(int i) const { return levelTable[i]; }
+
+    // coarsest level with at least one cell per pixel when drawn at w x h
+    int levelFor(float w, float h) const;
+
+    // true if any solid cell of `level`, with the mask stretched over
+    // `placed`, lies inside `box`
+    bool overlaps(const sf::FloatRect& box, const sf::FloatRect& placed, int level) const;
+
+private:
+    // serialized layout: uint32 level count, then per level width, height,
+    // wordsPerRow and the offset of its rows in words from the header end
+    struct LevelHeader { uint32_t width, height, wordsPerRow, offset; };
+
+    int levelCount = 0;
+    Level levelTable[MAX_LEVELS];
+    std::vector<uint64_t> storage;  // only when built, loaded masks point into the pack
+};
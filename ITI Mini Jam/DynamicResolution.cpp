@@ -0,0 +1,81 @@
+#include "DynamicResolution.h"
+
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace sf;
+using namespace std;
+
+DynamicResolution::DynamicResolution(unsigned W, unsigned H)
+    : width(W), height(H), avgFrameTime(targetFrameTime)
+{
+    if (!target.create(width, height)) {
+        cerr << "Warning: can't create world render texture, dynamic resolution disabled\n";
+        return;
+    }
+    MemoryTracker::addTexture(MemCategory::Game, target.getTexture());
+    target.setSmooth(true);
+    sprite.setTexture(target.getTexture());
+    enabled = true;
+}
+
+void DynamicResolution::adapt(float dt)
+{
+    if (!enabled) return;
+
+    // smooth out single-frame spikes, they are not a sustained load
+    avgFrameTime += (min(dt, 0.1f) - avgFrameTime) * 0.1f;
+
+    if (cooldown > 0) { cooldown--; return; }
+
+    float step = 0.05f;
+    if (avgFrameTime > targetFrameTime * 1.15f && scale > minScale) {
+        scale = max(minScale, scale - step);
+        goodFrames = 0;
+        cooldown = 15;
+    }
+    else if (avgFrameTime < targetFrameTime * 1.05f) {
+        // only climb back after two seconds of holding the budget
+        if (++goodFrames >= 120 && scale < maxScale) {
+            scale = min(maxScale, scale + step);
+            goodFrames = 0;
+            cooldown = 30;
+        }
+    }
+    else {
+        goodFrames = 0;
+    }
+}
+
+DrawTarget DynamicResolution::begin(RenderWindow& window, const View& view)
+{
+    if (!enabled) {
+        window.setView(view);
+        return DrawTarget(window);
+    }
+
+    View scaled = view;
+    scaled.setViewport(FloatRect(0.f, 0.f, scale, scale));
+    DrawTarget world(target);
+    world.clear(Color::Black);
+    target.setView(scaled);
+    return world;
+}
+
+void DynamicResolution::present(RenderWindow& window)
+{
+    if (!enabled) return;
+    target.display();
+
+    int w = max(1, static_cast<int>(lround(width * scale)));
+    int h = max(1, static_cast<int>(lround(height * scale)));
+    sprite.setTextureRect(IntRect(0, 0, w, h));
+    sprite.setScale(static_cast<float>(width) / w, static_cast<float>(height) / h);
+
+    window.setView(window.getDefaultView());
+    DrawScope scope(DrawCategory::Present);
+    DrawTarget(window).draw(sprite);
+}
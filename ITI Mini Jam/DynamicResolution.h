@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include "RenderStats.h"
+
+// Renders the world pass into an off-screen texture at a fraction of the
+// window resolution and upscales it. The fraction follows the measured
+// frame time between minScale and maxScale. UI is drawn to the window
+// afterwards so it stays at native resolution.
+class DynamicResolution {
+public:
+    float minScale = 0.5f, maxScale = 1.f;
+    float scale = 1.f;
+    float targetFrameTime = 1.f / 60.f;
+    bool enabled = false;
+
+    DynamicResolution(unsigned width, unsigned height);
+
+    // feed the last frame's duration once per frame
+    void adapt(float dt);
+
+    // clears the off-screen target and sets `view` on the scaled viewport
+    DrawTarget begin(sf::RenderWindow& window, const sf::View& view);
+    // upscales the world pass onto the window (no-op when disabled)
+    void present(sf::RenderWindow& window);
+
+private:
+    sf::RenderTexture target;
+    sf::Sprite sprite;
+    unsigned width, height;
+
+    float avgFrameTime;
+    int goodFrames = 0;
+    int cooldown = 0;
+};
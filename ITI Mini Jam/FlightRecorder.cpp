@@ -0,0 +1,165 @@
+#include "FlightRecorder.h"
+
+#include "MemoryTracker.h"
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    using SteadyClock = chrono::steady_clock;
+
+    const int ZONES = static_cast<int>(Zone::Count);
+    const int COUNTERS = static_cast<int>(Counter::Count);
+    const char* zoneNames[ZONES] = { "events", "update", "draw", "present", "transition", "sim", "audio" };
+    const char* counterNames[COUNTERS] = { "draws", "vertices", "allocs", "rain", "props", "obstacles" };
+
+    struct FrameRecord {
+        uint32_t frame;
+        float time;         // end of the frame, seconds since start
+        float seconds;      // since the previous frame ended
+        float zones[ZONES];
+        uint32_t counters[COUNTERS];
+    };
+
+    struct EventRecord {
+        uint32_t frame;
+        float time;
+        int type;
+        int code;           // key or mouse button, -1 otherwise
+    };
+
+    FrameRecord frames[FlightRecorder::FRAMES];
+    EventRecord events[FlightRecorder::EVENTS];
+    uint32_t frameCount = 0, eventCount = 0;
+
+    // microseconds per zone for the running frame, added to from any thread
+    atomic<uint32_t> zoneMicros[ZONES];
+    uint32_t counters[COUNTERS];
+
+    const SteadyClock::time_point start = SteadyClock::now();
+    SteadyClock::time_point lastEnd = start;
+    float threshold = 0.05f;
+    float lastDump = -FlightRecorder::COOLDOWN;
+    int dumps = 0;
+    size_t allocsAtFrameStart = 0;
+
+    float since(SteadyClock::time_point t) { return chrono::duration<float>(t - start).count(); }
+
+    const char* eventName(int type)
+    {
+        switch (type) {
+        case Event::Closed: return "Closed";
+        case Event::Resized: return "Resized";
+        case Event::LostFocus: return "LostFocus";
+        case Event::GainedFocus: return "GainedFocus";
+        case Event::KeyPressed: return "KeyPressed";
+        case Event::KeyReleased: return "KeyReleased";
+        case Event::MouseButtonPressed: return "MousePressed";
+        case Event::MouseButtonReleased: return "MouseReleased";
+        default: return "Other";
+        }
+    }
+
+    void dump(const FrameRecord& hitch)
+    {
+        string path = "hitch_" + to_string(dumps) + ".txt";
+        ofstream out(path);
+        if (!out) {
+            cerr << "Warning: can't write " << path << "\n";
+            return;
+        }
+
+        out << fixed << setprecision(2);
+        out << "Hitch: frame " << hitch.frame << " took " << hitch.seconds * 1000.f << " ms (threshold "
+            << threshold * 1000.f << " ms) at " << hitch.time << " s\n\n";
+
+        out << "frame,time,ms";
+        for (auto name : zoneNames) out << ',' << name;
+        for (auto name : counterNames) out << ',' << name;
+        out << '\n';
+
+        uint32_t first = frameCount > FlightRecorder::FRAMES ? frameCount - FlightRecorder::FRAMES : 0;
+        float from = hitch.time - FlightRecorder::SECONDS;
+        for (uint32_t n = first; n < frameCount; n++) {
+            const FrameRecord& f = frames[n % FlightRecorder::FRAMES];
+            if (f.time < from) continue;
+            out << f.frame << ',' << setprecision(3) << f.time << setprecision(2) << ',' << f.seconds * 1000.f;
+            for (float z : f.zones) out << ',' << z * 1000.f;
+            for (uint32_t c : f.counters) out << ',' << c;
+            out << (f.seconds > threshold ? ",*\n" : "\n");
+        }
+
+        out << "\ninput events: frame,time,type,code\n";
+        uint32_t firstEvent = eventCount > FlightRecorder::EVENTS ? eventCount - FlightRecorder::EVENTS : 0;
+        for (uint32_t n = firstEvent; n < eventCount; n++) {
+            const EventRecord& e = events[n % FlightRecorder::EVENTS];
+            if (e.time < from) continue;
+            out << e.frame << ',' << setprecision(3) << e.time << ',' << eventName(e.type) << ',' << e.code << '\n';
+        }
+
+        cerr << "Hitch of " << hitch.seconds * 1000.f << " ms at frame " << hitch.frame << ", wrote " << path << "\n";
+        dumps++;
+    }
+}
+
+void FlightRecorder::setThreshold(float seconds)
+{
+    threshold = seconds;
+}
+
+void FlightRecorder::addZoneTime(Zone z, SteadyClock::duration d)
+{
+    auto us = chrono::duration_cast<chrono::microseconds>(d).count();
+    zoneMicros[static_cast<int>(z)].fetch_add(static_cast<uint32_t>(us), memory_order_relaxed);
+}
+
+void FlightRecorder::setCounter(Counter c, uint32_t value)
+{
+    counters[static_cast<int>(c)] = value;
+}
+
+void FlightRecorder::recordEvent(const Event& e)
+{
+    // mouse moves would push everything else out of the ring
+    if (e.type == Event::MouseMoved) return;
+
+    EventRecord& r = events[eventCount++ % EVENTS];
+    r.frame = frameCount;
+    r.time = since(SteadyClock::now());
+    r.type = e.type;
+    r.code = e.type == Event::KeyPressed || e.type == Event::KeyReleased ? static_cast<int>(e.key.code)
+        : e.type == Event::MouseButtonPressed || e.type == Event::MouseButtonReleased ? static_cast<int>(e.mouseButton.button)
+        : -1;
+}
+
+void FlightRecorder::endFrame(bool fullRate)
+{
+    SteadyClock::time_point now = SteadyClock::now();
+    size_t allocs = MemoryTracker::allocationCount();
+    counters[static_cast<int>(Counter::Allocations)] = static_cast<uint32_t>(allocs - allocsAtFrameStart);
+    allocsAtFrameStart = allocs;
+
+    FrameRecord& f = frames[frameCount % FRAMES];
+    f.frame = frameCount;
+    f.time = since(now);
+    f.seconds = chrono::duration<float>(now - lastEnd).count();
+    for (int i = 0; i < ZONES; i++)
+        f.zones[i] = zoneMicros[i].exchange(0, memory_order_relaxed) * 1e-6f;
+    for (int i = 0; i < COUNTERS; i++) {
+        f.counters[i] = counters[i];
+        counters[i] = 0;
+    }
+    frameCount++;
+
+    if (fullRate && threshold > 0.f && f.seconds > threshold && dumps < MAX_DUMPS && f.time - lastDump > COOLDOWN) {
+        dump(f);
+        lastDump = f.time;
+    }
+    // the dump is not part of the next frame
+    lastEnd = SteadyClock::now();
+}
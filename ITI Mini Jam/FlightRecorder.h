@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+enum class Zone { Events, Update, Draw, Present, Transition, SimTick, Audio, Count };
+enum class Counter { DrawCalls, Vertices, Allocations, RainDrops, Props, Obstacles, Count };
+
+// Always-on hitch recorder. Every frame leaves one fixed-size record in a
+// ring (frame time, time per zone, counters) and input events go to a
+// second ring, so recording costs a few stores and never allocates. When
+// a full-rate frame takes longer than the threshold, the last SECONDS of
+// both rings are written to hitch_<n>.txt next to the executable.
+//
+// Zones may be timed from any thread (the sim ticks and the audio thread
+// add to the frame that is running when they finish); everything else is
+// main thread only.
+class FlightRecorder {
+public:
+    static const int FRAMES = 600;      // 10 s at 60 fps
+    static const int EVENTS = 256;
+    static constexpr float SECONDS = 5.f;
+    static constexpr float COOLDOWN = 2.f;  // between dumps, the dump itself is slow
+    static const int MAX_DUMPS = 20;
+
+    // 0 turns dumping off, recording goes on
+    static void setThreshold(float seconds);
+
+    static void addZoneTime(Zone z, std::chrono::steady_clock::duration d);
+    static void setCounter(Counter c, uint32_t value);
+    static void recordEvent(const sf::Event& e);
+
+    // closes the running frame; `fullRate` frames are the only ones that
+    // can count as a hitch (idle frames are long on purpose)
+    static void endFrame(bool fullRate);
+};
+
+// adds its lifetime to `zone` of the running frame
+class ZoneScope {
+public:
+    explicit ZoneScope(Zone zone) : zone(zone), begin(std::chrono::steady_clock::now()) {}
+    ~ZoneScope() { FlightRecorder::addZoneTime(zone, std::chrono::steady_clock::now() - begin); }
+
+    ZoneScope(const ZoneScope&) = delete;
+    ZoneScope& operator=(const ZoneScope&) = delete;
+
+private:
+    Zone zone;
+    std::chrono::steady_clock::time_point begin;
+};
@@ -0,0 +1,151 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+using namespace std;
+
+namespace {
+    double seconds(FramePacer::Clock::duration d)
+    {
+        return chrono::duration<double>(d).count();
+    }
+
+    FramePacer::Clock::duration toDuration(double s)
+    {
+        return chrono::duration_cast<FramePacer::Clock::duration>(chrono::duration<double>(s));
+    }
+}
+
+FramePacer::FramePacer()
+{
+#ifdef _WIN32
+    // 1ms scheduler ticks instead of 15.6ms, or every sleep overshoots
+    timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::setTarget(unsigned hz)
+{
+    if (hz == targetHz) return;
+    targetHz = hz;
+    hasDeadline = false;
+}
+
+void FramePacer::setVsync(bool on, unsigned refresh)
+{
+    vsync = on;
+    refreshHz = max(refresh, 1u);
+    hasDeadline = false;
+}
+
+void FramePacer::wait()
+{
+    if (targetHz == 0) return;
+
+    const Clock::duration step = toDuration(period());
+    Clock::time_point now = Clock::now();
+    if (!hasDeadline) {
+        deadline = now;
+        hasDeadline = true;
+    }
+
+    if (now > deadline) {
+        late++;
+        // more than a frame behind: start over from now rather than
+        // rushing out frames to catch up
+        if (now - deadline > step) deadline = now;
+    }
+
+    // with vsync, display() blocks until the vblank after we release it,
+    // so stop half a refresh early and let it pick the one at the deadline
+    Clock::time_point until = deadline;
+    if (vsync) until -= toDuration(0.5 / refreshHz);
+
+    Clock::time_point wake = until - toDuration(spinMargin);
+    if (now < wake) {
+        this_thread::sleep_until(wake);
+        // how late the OS woke us decides how much to spin next time
+        double overshoot = max(seconds(Clock::now() - wake), 0.0);
+        spinMargin = min(max(spinMargin * 0.9 + (overshoot * 1.5 + 0.0002) * 0.1, 0.0003), 0.004);
+    }
+    while (Clock::now() < until)
+        this_thread::yield();
+
+    deadline += step;
+}
+
+void FramePacer::presented(bool record)
+{
+    Clock::time_point now = Clock::now();
+    double interval = hasPresent ? seconds(now - lastPresent) : 0.0;
+    bool counted = record && hasPresent;
+    lastPresent = now;
+    hasPresent = true;
+    if (!counted) return;
+
+    int bucket = min(static_cast<int>(interval / BUCKET_SECONDS), static_cast<int>(BUCKETS));
+    histogram[bucket]++;
+    frames++;
+    sum += interval;
+    sumSq += interval * interval;
+    worst = max(worst, interval);
+    // a whole refresh slipped
+    if (targetHz && interval > period() * 1.5) missed++;
+}
+
+void FramePacer::resetStats()
+{
+    fill(begin(histogram), end(histogram), 0u);
+    frames = missed = late = 0;
+    sum = sumSq = worst = 0.0;
+}
+
+double FramePacer::percentile(double p) const
+{
+    unsigned rank = static_cast<unsigned>(ceil(p * frames));
+    unsigned seen = 0;
+    for (int i = 0; i <= BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= rank && seen > 0) return (i + 1) * BUCKET_SECONDS;     // upper edge of the bucket
+    }
+    return worst;
+}
+
+void FramePacer::report(ostream& out) const
+{
+    out << "Frame pacing: target " << (targetHz ? to_string(targetHz) + " Hz" : string("unpaced"))
+        << (vsync ? ", vsync " + to_string(refreshHz) + " Hz" : string()) << "\n";
+    if (frames == 0) {
+        out << "  no frames recorded\n";
+        return;
+    }
+
+    double mean = sum / frames;
+    double jitter = sqrt(max(sumSq / frames - mean * mean, 0.0));
+    out << "  frames " << frames << ", mean " << mean * 1000.0 << " ms (" << 1.0 / mean << " fps)"
+        << ", jitter " << jitter * 1000.0 << " ms\n";
+    out << "  p50 " << percentile(0.5) * 1000.0 << " ms, p99 " << percentile(0.99) * 1000.0
+        << " ms, worst " << worst * 1000.0 << " ms\n";
+    out << "  missed deadlines " << missed << " (" << 100.0 * missed / frames << "%)"
+        << ", late frames " << late << "\n";
+}
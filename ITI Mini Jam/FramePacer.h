@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+
+// Paces presents to a target rate against a steady clock: sleeps until
+// just before the deadline, then spins the rest, so frames land within
+// a few microseconds instead of the millisecond overshoot of a plain
+// sleep. The spin margin follows how late the OS has actually been
+// waking us. With vsync on, display() does the final wait and the pacer
+// only keeps the frame rate at or under the target.
+//
+// Present-to-present intervals go into a histogram for the pacing report.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 0.25ms buckets up to 50ms, then one overflow bucket
+    static const int BUCKETS = 200;
+    static constexpr double BUCKET_SECONDS = 0.00025;
+
+    FramePacer();
+    ~FramePacer();
+
+    // frames per second, 0 = unpaced
+    void setTarget(unsigned hz);
+    unsigned target() const { return targetHz; }
+    // refreshHz: the display's rate, used to present on the right vblank
+    void setVsync(bool on, unsigned refreshHz = 60);
+
+    // right before window.display()
+    void wait();
+    // right after it; `record` is false for frames that don't say anything
+    // about pacing (after waiting for events, after a mode switch)
+    void presented(bool record);
+
+    // seconds per frame at the target, 0 when unpaced
+    double period() const { return targetHz ? 1.0 / targetHz : 0.0; }
+
+    void resetStats();
+    void report(std::ostream& out) const;
+
+private:
+    double percentile(double p) const;
+
+    unsigned targetHz = 0;
+    bool vsync = false;
+    unsigned refreshHz = 60;
+
+    Clock::time_point deadline;
+    Clock::time_point lastPresent;
+    bool hasDeadline = false, hasPresent = false;
+    double spinMargin = 0.002;      // seconds left to spin after the sleep
+
+    unsigned histogram[BUCKETS + 1] = {};
+    unsigned frames = 0, missed = 0, late = 0;
+    double sum = 0.0, sumSq = 0.0, worst = 0.0;
+};
@@ -0,0 +1,97 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace sf;
+using namespace std;
+
+FrameScheduler::FrameScheduler(RenderWindow& w, unsigned limit)
+    : window(w), activeLimit(limit)
+{
+    pacer.setTarget(activeLimit);
+}
+
+bool FrameScheduler::pollEvent(Event& e)
+{
+    bool got;
+    if (!polling && (current == Static || current == Background)) {
+        got = window.waitEvent(e);
+        waited = true;
+    }
+    else {
+        got = window.pollEvent(e);
+    }
+    polling = got;
+    if (!got) return false;
+
+    switch (e.type) {
+    case Event::LostFocus:
+        focused = false;
+        break;
+    case Event::GainedFocus:
+        focused = true;
+        inputClock.restart();
+        setMode(Active);
+        break;
+    case Event::KeyPressed:
+    case Event::TextEntered:
+    case Event::MouseMoved:
+    case Event::MouseButtonPressed:
+    case Event::MouseWheelScrolled:
+        inputClock.restart();
+        if (current == Idle) setMode(Active);
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+float FrameScheduler::beginFrame()
+{
+    float dt = frameClock.restart().asSeconds();
+    if (waited) {
+        waited = false;
+        steadyFrame = false;
+        rawDt = 0.f;
+        return 0.f;
+    }
+    rawDt = min(dt, MAX_DT);
+
+    // a paced frame within 5% of the period is timer noise, animations
+    // step by exactly one period instead of wobbling around it
+    float period = static_cast<float>(pacer.period());
+    if (period > 0.f && fabs(dt - period) < period * 0.05f) dt = period;
+    return min(dt, MAX_DT);
+}
+
+void FrameScheduler::present()
+{
+    work = workClock.getElapsedTime().asSeconds();
+    pacer.wait();
+    window.display();
+    pacer.presented(steady());
+    workClock.restart();
+}
+
+void FrameScheduler::endFrame(bool animating)
+{
+    Mode next;
+    if (!focused) next = Background;
+    else if (!animating) next = Static;
+    else if (inputClock.getElapsedTime().asSeconds() > idleAfter) next = Idle;
+    else next = Active;
+    steadyFrame = next == current;
+    setMode(next);
+}
+
+void FrameScheduler::setMode(Mode m)
+{
+    if (m == current) return;
+    // the first frame after a switch still measures the old rate
+    steadyFrame = false;
+    if (m == Idle) pacer.setTarget(idleLimit);
+    else if (current == Idle) pacer.setTarget(activeLimit);
+    current = m;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "FramePacer.h"
+
+// Decides how often the main loop runs: full rate while something moves,
+// a low rate once an animated screen (the menu rain) has been left alone
+// for a while, and event-driven (one frame per event) when the screen is
+// static or the window is in the background. Any input goes straight back
+// to full rate.
+class FrameScheduler {
+public:
+    enum Mode { Active, Idle, Static, Background };
+
+    unsigned idleLimit = 20;    // frame limit in Idle
+    float idleAfter = 30.f;     // seconds without input before going Idle
+    static constexpr float MAX_DT = 0.1f;   // longer frames (hitches, dragging the window) count as this
+
+    // does the frame limiting; its stats only cover steady Active frames
+    FramePacer pacer;
+
+    // activeLimit: the normal frame limit, 0 = unlimited
+    FrameScheduler(sf::RenderWindow& window, unsigned activeLimit);
+
+    // replaces window.pollEvent: the first call of a frame waits for an
+    // event when the previous frame was Static or Background
+    bool pollEvent(sf::Event& e);
+
+    // dt of this frame, 0 after waiting so nothing jumps on wake-up
+    float beginFrame();
+    // the same before snapping to the period, what load measurement wants
+    float frameTime() const { return rawDt; }
+    // paces and presents the frame, replaces window.display()
+    void present();
+    // time the last presented frame was busy: from the previous present
+    // to the pacer wait, so limiter sleeps and vsync don't count
+    float workTime() const { return work; }
+    // picks the next frame's mode; `animating` is false when redrawing
+    // the same screen again would produce the same image
+    void endFrame(bool animating);
+
+    Mode mode() const { return current; }
+    // simulation and audio are held while the window is in the background
+    bool paused() const { return current == Background; }
+    // true when this frame's dt is a real full-rate frame time
+    bool steady() const { return current == Active && steadyFrame; }
+
+private:
+    void setMode(Mode m);
+
+    sf::RenderWindow& window;
+    unsigned activeLimit;
+    Mode current = Active;
+    bool focused = true;
+    bool polling = false;       // inside a frame's event loop
+    bool waited = false;
+    bool steadyFrame = false;
+    float rawDt = 0.f;
+    float work = 0.f;
+    sf::Clock workClock;
+    sf::Clock frameClock;
+    sf::Clock inputClock;
+};
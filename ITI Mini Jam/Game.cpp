@@ -1,123 +1,343 @@
 #include "Game.h"
 
+#include "AssetPack.h"
+#include "LevelGenerator.h"
+#include "MemoryTracker.h"
+
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include <ctime>
-#include <cstdlib>
+#include <iostream>
 
 using namespace sf;
 using namespace std;
 
-Game::Game(float W, float H, SoundManager* sm)
+static size_t levelArenaSize()
+{
+    return sizeof(Platform) * Game::MAX_PLATFORMS + sizeof(Obstacle) * Game::MAX_OBSTACLES
+        + sizeof(Sprite) * Game::NUM_PROPS * 2 + 256; // props can all land in one pool, plus alignment
+}
+
+Game::Game(float W, float H, SoundManager* sm, bool tileTerrain_)
     : WIDTH(W), HEIGHT(H),
-    bg(5, W * 10000.f, H, { 0.f, 25.f , 60.f, 110.f , 120.f}, 0),
-	BGground(1, W * 10000.f, H, { 0.f }, 5),
-    ground(50.f, H - 200.f, W * 10000.f - 100.f, 200.f, Color(0, 0, 0, 0))
+    bg(5, W, H, { 0.f, 25.f , 60.f, 110.f , 120.f}, 0),
+	BGground(1, W, H, { 0.f }, 5),
+    arena(levelArenaSize()),
+    ground(50.f, H - 200.f, W * 10000.f - 100.f, 200.f, Color(0, 0, 0, 0)),
+    rewind(REWIND_SECONDS * 60)     // one state per 60Hz tick
 {
+    MemoryScope scope(MemCategory::Game);
     soundMgr = sm;
     player.soundMgr = sm;
+    tileTerrain = tileTerrain_;
     WORLD_RIGHT = WIDTH * 10000.f;
 
+    animations.reserve(64);
+    player.attachAnimation(animations);
+
     camera.setSize(WIDTH, HEIGHT);
     camera.setCenter(WIDTH / 2.f, HEIGHT / 2.f);
-
-    platforms.emplace_back(800.f, HEIGHT - 250.f, 300.f, 40.f, Color(50, 50, 50));
-    platforms.emplace_back(1400.f, HEIGHT - 350.f, 250.f, 40.f, Color(50, 50, 50));
-    platforms.emplace_back(2000.f, HEIGHT - 200.f, 400.f, 40.f, Color(50, 50, 50));
-
-    obstacles.emplace_back(1100.f, HEIGHT - 220.f, 90.f, 140.f);
-    obstacles.emplace_back(1750.f, HEIGHT - 230.f, 90.f, 140.f);
-    obstacles.emplace_back(2400.f, HEIGHT - 220.f, 90.f, 140.f);
+    view = camera;
 
     // ---- LOAD PROP TEXTURES (FIXED) ----
+    propTextures.reserve(2);
     propTextures.emplace_back();
-    propTextures.back().loadFromFile("Assets/Props/Leaves1.png");
+    AssetPack::loadTexture(propTextures.back(), "Assets/Props/Leaves1.png");
 
     propTextures.emplace_back();
-    propTextures.back().loadFromFile("Assets/Props/Tree.png");
+    AssetPack::loadTexture(propTextures.back(), "Assets/Props/Tree.png");
 
-    // ---- RANDOM PROPS ----
-    if (propTextures.empty()) return;
+    for (auto& t : propTextures)
+        MemoryTracker::addTexture(MemCategory::Game, t);
+
+    // obstacles stay red rectangles if the art is missing
+    if (AssetPack::loadTexture(spikeTexture, "Assets/Spikes/Spikes2.png")) {
+        MemoryTracker::addTexture(MemCategory::Game, spikeTexture);
+        if (!AssetPack::loadMask(spikeMask, "Assets/Spikes/Spikes2.png"))
+            cerr << "Warning: no collision mask for Spikes2.png, using its rectangle\n";
+    }
+
+    levelSeed = static_cast<unsigned>(time(0));
+    buildLevel();
+    player.updateAnimation();
+    capture(startState);
+}
 
-    srand((unsigned)(time(0)));
-    int numProps = 5000;
+vector<string> Game::assets()
+{
+    return {
+        "Assets/Character/idle.png", "Assets/Character/run.png", "Assets/Character/jump.png",
+        "Assets/Props/Leaves1.png", "Assets/Props/Tree.png", "Assets/Spikes/Spikes2.png",
+        "Assets/Backgrounds/BG_00.png", "Assets/Backgrounds/BG_01.png", "Assets/Backgrounds/BG_02.png",
+        "Assets/Backgrounds/BG_03.png", "Assets/Backgrounds/BG_04.png", "Assets/Backgrounds/BG_05.png",
+    };
+}
 
-    for (int i = 0; i < numProps; i++) {
-        Sprite s;
-        int randomNumberToCReateBushesAndTrees = rand() % propTextures.size();
-        s.setTexture(propTextures[randomNumberToCReateBushesAndTrees]);
+// (re)builds every level entity in the arena's pools, same seed gives the
+// same level; a rebuild reuses the existing objects, only the tile
+// terrain's cells and mesh can grow if the level is longer than any before
+void Game::buildLevel()
+{
+    // the first build carves the pools, later ones take their objects
+    // back and only reset them
+    if (platforms.capacity() == 0) {
+        arena.rewind();
+        platforms.reserve(arena, MAX_PLATFORMS);
+        obstacles.reserve(arena, MAX_OBSTACLES);
+        treesProp.reserve(arena, NUM_PROPS);
+        leavesProp.reserve(arena, NUM_PROPS);
+    }
+    platforms.recycle();
+    obstacles.recycle();
+    treesProp.recycle();
+    leavesProp.recycle();
+
+    LevelLayout layout;
+    LevelGenerator::generate(levelSeed, WORLD_RIGHT, HEIGHT, layout);
+
+    const FloatRect& g = layout.ground;
+    if (tileTerrain) {
+        LevelGenerator::generateTerrain(levelSeed, layout, terrain);
+        terrainLeft = terrain.left;
+        ground.place(terrain.right(), g.top, g.left + g.width - terrain.right(), g.height, Color(0, 0, 0, 0));
+        buildTerrainMesh(terrain.rowAt(g.top));
+    }
+    else {
+        ground.place(g.left, g.top, g.width, g.height, Color(0, 0, 0, 0));
+    }
+    for (int i = 0; i < layout.platformCount; i++) {
+        const FloatRect& r = layout.platforms[i];
+        platforms.acquire().place(r.left, r.top, r.width, r.height, Color(50, 50, 50));
+    }
+    for (int i = 0; i < layout.obstacleCount; i++) {
+        const FloatRect& r = layout.obstacles[i];
+        Obstacle& o = obstacles.acquire();
+        o.place(r.left + r.width / 2.f, r.top + r.height / 2.f, r.width, r.height);
+        if (spikeTexture.getSize().x) o.setArt(spikeTexture, &spikeMask);
+    }
+    setOrigin(originX);
 
-        float x = 100.f + (float)(rand()) / RAND_MAX * (WIDTH * 10000.f - 200.f);
+    // ---- RANDOM PROPS ----
+    rng = Rng::seeded(levelSeed);
+
+    for (int i = 0; i < NUM_PROPS; i++) {
+        int randomNumberToCReateBushesAndTrees = rng.next() % propTextures.size();
+
+        float x = 100.f + rng.uniform() * (WIDTH * 10000.f - 200.f);
         float y = 0;
 
         if (randomNumberToCReateBushesAndTrees == 0) {
+            Sprite& s = leavesProp.acquire();
+            s.setTexture(propTextures[0], true);
             float groundTop = HEIGHT - 200;
             s.setScale(0.4f, 0.4f);
             y = groundTop - s.getTexture()->getSize().y * 0.4f;
             s.setPosition(x, y);
-            leavesProp.push_back(s);
         }
         else {
+            Sprite& s = treesProp.acquire();
+            s.setTexture(propTextures[1], true);
             float groundTop = HEIGHT - 50;
             s.setScale(1.f, 1.f);
             y = groundTop - s.getTexture()->getSize().y;
             s.setPosition(x, y);
-            treesProp.push_back(s);
         }
     }
 
+    visibleTrees = static_cast<size_t>(treesProp.size() * propDensity);
+    visibleLeaves = static_cast<size_t>(leavesProp.size() * propDensity);
 }
 
-bool Game::update(float dt)
+// re-derives the simulation's copies of the level geometry for a new
+// origin; they are computed from the level each time so nothing drifts
+void Game::setOrigin(double x)
 {
-    player.updateMovement();
-    player.onGround = false;
+    originX = x;
+    float shift = static_cast<float>(x);
 
-    CollisionManager::resolveAll(player, platforms, ground, player.velY, player.onGround);
+    hazards.clear();
+    hazards.reserve(MAX_OBSTACLES);
+    for (auto& o : obstacles) {
+        FloatRect b = o.getBounds();
+        b.left -= shift;
+        hazards.add(b);
+    }
+    hazardHits.assign(hazards.maskWords(), 0);
+    if (tileTerrain) terrain.left = static_cast<float>(terrainLeft - x);
+}
 
+// moves the simulation `shift` to the right along the level; shifts are
+// whole REBASE_STEPs so positions move without rounding
+void Game::rebase(float shift)
+{
+    player.body.x -= shift;
+    player.updateAnimation();
+    camera.move(-shift, 0.f);
+    setOrigin(originX + shift);
+}
+
+Game::~Game()
+{
+    for (auto& t : propTextures)
+        MemoryTracker::removeTexture(MemCategory::Game, t);
+    MemoryTracker::removeTexture(MemCategory::Game, spikeTexture);
+}
+
+bool Game::update(float dt, InputBuffer& input)
+{
+    MemoryScope scope(MemCategory::Game);
+
+    if (input.isHeld(Action::Rewind)) {
+        WorldState state;
+        if (rewind.pop(state)) restore(state);
+        return false;
+    }
+
+    player.updateMovement(input, dt);
+    CollisionManager::resolveAll(player.body, player.tuning, platforms, ground, tileTerrain ? &terrain : nullptr, static_cast<float>(originX));
+
+    animations.update(dt);
     player.updateAnimation();
     syncRunSound();
 
-    if (checkObstacleCollision()) {
+    if (checkObstacleCollision() || fellOutOfWorld()) {
         return true;
     }
 
     float direction = 0;
-    if (Keyboard::isKeyPressed(Keyboard::A) || Keyboard::isKeyPressed(Keyboard::Left)) direction = -1;
-    else if (Keyboard::isKeyPressed(Keyboard::D) || Keyboard::isKeyPressed(Keyboard::Right)) direction = 1;
+    if (input.isHeld(Action::Left)) direction = -1;
+    else if (input.isHeld(Action::Right)) direction = 1;
 
     if (direction != 0) bg.update(dt, direction, 3, bg.layerCount);
     bg.update(dt, -1, 2, 3);
 
+    if (fabs(player.body.x) > REBASE_DISTANCE)
+        rebase(floor(player.body.x / REBASE_STEP) * REBASE_STEP);
+
     float px = player.getPosition().x;
-    px = max(px, WORLD_LEFT + WIDTH / 2.f);
-    px = min(px, WORLD_RIGHT - WIDTH / 2.f);
+    px = max(px, static_cast<float>(WORLD_LEFT - originX) + WIDTH / 2.f);
+    px = min(px, static_cast<float>(WORLD_RIGHT - originX) - WIDTH / 2.f);
     camera.setCenter(px, HEIGHT / 2.f);
 
+    capture(rewind.push());
     return false;
 }
 
-void Game::draw(RenderWindow& window)
+void Game::capture(WorldState& out) const
+{
+    out.levelSeed = levelSeed;
+    out.rng = rng.state;
+
+    out.player = player.body;
+
+    out.animClip = animations.clipOf(player.animEntity);
+    out.animFrame = animations.frameOf(player.animEntity);
+    out.animTime = animations.timeOf(player.animEntity);
+
+    out.originX = originX;
+    out.cameraX = camera.getCenter().x;
+    out.cameraY = camera.getCenter().y;
+    for (int i = 0; i < WorldState::MAX_LAYERS; i++)
+        out.bgOffsets[i] = i < bg.layerCount ? bg.offsets[i] : 0.f;
+}
+
+void Game::restore(const WorldState& state)
 {
-    window.setView(camera);
-    bg.draw(window);  
+    if (state.levelSeed != levelSeed) {
+        levelSeed = state.levelSeed;
+        buildLevel();
+    }
+    if (state.originX != originX) setOrigin(state.originX);
+    rng.state = state.rng;
 
-    ground.draw(window);   
+    player.body = state.player;
 
-    for (auto& tree : treesProp)
-        if (isVisible(tree))
-            window.draw(tree);
+    animations.seek(player.animEntity, state.animClip, state.animFrame, state.animTime);
+    animations.update(0.f);
+    player.updateAnimation();
 
-    BGground.draw(window);
+    camera.setCenter(state.cameraX, state.cameraY);
+    for (int i = 0; i < bg.layerCount && i < WorldState::MAX_LAYERS; i++)
+        bg.offsets[i] = state.bgOffsets[i];
 
-    for (auto& plat : platforms) plat.draw(window);
-    for (auto& o : obstacles) o.draw(window);
+    syncRunSound();
+}
+
+void Game::publish(WorldSnapshot& out) const
+{
+    out.originX = originX;
+    out.cameraCenter = camera.getCenter();
+    out.playerTexture = player.sprite.getTexture();
+    out.playerRect = player.sprite.getTextureRect();
+    out.playerPosition = player.sprite.getPosition();
+    out.playerScale = player.sprite.getScale();
+    for (int i = 0; i < bg.layerCount && i < WorldSnapshot::MAX_LAYERS; i++)
+        out.bgOffsets[i] = bg.offsets[i];
+}
 
+void Game::applySnapshot(const WorldSnapshot& snap)
+{
+    view.setCenter(snap.cameraCenter);
+    renderOrigin = snap.originX;
+
+    Sprite& s = player.view;
+    if (snap.playerTexture && snap.playerTexture != s.getTexture()) s.setTexture(*snap.playerTexture);
+    s.setTextureRect(snap.playerRect);
+    s.setPosition(snap.playerPosition);
+    s.setScale(snap.playerScale);
+
+    float viewLeft = snap.cameraCenter.x - WIDTH / 2.f;
+    bg.applyOffsets(snap.bgOffsets, viewLeft, renderOrigin);
+    BGground.applyOffsets(BGground.offsets.data(), viewLeft, renderOrigin);
+}
 
-    for (auto& leaf : leavesProp)
-        if (isVisible(leaf))
-            window.draw(leaf);
+int Game::distance() const
+{
+    double start = startState.originX + startState.player.x;
+    double x = renderOrigin + player.view.getPosition().x;
+    return max(static_cast<int>((x - start) / PIXELS_PER_METER), 0);
+}
 
-    player.draw(window);
+int Game::hazardsCleared() const
+{
+    double x = renderOrigin + player.view.getPosition().x;
+    int cleared = 0;
+    for (const Obstacle& o : obstacles) {
+        FloatRect b = o.getBounds();
+        if (b.left + b.width < x) cleared++;
+    }
+    return cleared;
+}
+
+void Game::draw(DrawTarget& target)
+{
+    MemoryScope scope(MemCategory::Game);
+    DrawScope drawScope(DrawCategory::Game);
+    bg.draw(target);
+
+    // the view is relative to the origin, the level isn't
+    RenderStates level;
+    level.transform.translate(-static_cast<float>(renderOrigin), 0.f);
+
+    ground.draw(target, level);
+
+    for (size_t i = 0; i < visibleTrees; i++)
+        if (isVisible(treesProp[i]))
+            target.draw(treesProp[i], level);
+
+    BGground.draw(target);
+    if (terrainMesh.getVertexCount() > 0) target.draw(terrainMesh, level);
+
+    for (auto& plat : platforms) plat.draw(target, level);
+    for (auto& o : obstacles) o.draw(target, level);
+
+
+    for (size_t i = 0; i < visibleLeaves; i++)
+        if (isVisible(leavesProp[i]))
+            target.draw(leavesProp[i], level);
+
+    player.draw(target);
 }
 
 void Game::syncRunSound()
@@ -132,38 +352,88 @@ void Game::syncRunSound()
     }
 }
 
+// boxes first, then the art's mask for the few that overlap
 bool Game::checkObstacleCollision()
 {
-    FloatRect playerBounds = player.getGlobalBounds();
-    for (auto& o : obstacles) {
-        if (playerBounds.intersects(o.getBounds())) {
-            if (soundMgr) soundMgr->stopSFX("run");
-            return true;
+    FloatRect box = player.getGlobalBounds();
+    if (hazards.query(box, hazardHits.data()) == 0) return false;
+
+    bool hit = false;
+    for (int w = 0; w < hazards.maskWords() && !hit; w++) {
+        for (uint32_t bits = hazardHits[w]; bits && !hit; bits &= bits - 1) {
+            const Obstacle& o = obstacles[w * 32 + countr_zero(bits)];
+            FloatRect bounds = o.getBounds();
+            bounds.left -= static_cast<float>(originX);
+            hit = o.hits(box, bounds);
+        }
+    }
+    if (hit && soundMgr) soundMgr->stopSFX("run");
+    return hit;
+}
+
+bool Game::fellOutOfWorld() const
+{
+    return player.body.y - player.tuning.originY > HEIGHT;
+}
+
+// raised tiles are drawn like platforms, pits are cut out of the ground
+// texture; the plain ground is left to BGground
+void Game::buildTerrainMesh(int groundRow)
+{
+    terrainMesh.clear();
+    terrainMesh.setPrimitiveType(Triangles);
+
+    const Color raised(50, 50, 50);
+    const Color pit(15, 12, 20);
+    auto tri = [&](Vector2f a, Vector2f b, Vector2f c, Color color) {
+        terrainMesh.append(Vertex(a, color));
+        terrainMesh.append(Vertex(b, color));
+        terrainMesh.append(Vertex(c, color));
+    };
+
+    for (int r = 0; r < terrain.rows; r++)
+    {
+        for (int c = 0; c < terrain.cols; c++)
+        {
+            TileGrid::Tile t = terrain.at(c, r);
+            FloatRect cell = terrain.cellRect(c, r);
+            Vector2f tl(cell.left, cell.top), tr(cell.left + cell.width, cell.top);
+            Vector2f bl(cell.left, cell.top + cell.height), br(cell.left + cell.width, cell.top + cell.height);
+
+            if (r >= groundRow) {
+                if (t == TileGrid::Empty) { tri(tl, tr, br, pit); tri(tl, br, bl, pit); }
+            }
+            else if (t == TileGrid::Solid) { tri(tl, tr, br, raised); tri(tl, br, bl, raised); }
+            else if (t == TileGrid::SlopeUp) tri(bl, br, tr, raised);
+            else if (t == TileGrid::SlopeDown) tri(tl, br, bl, raised);
         }
     }
-    return false;
 }
 
 bool Game::isVisible(const sf::Sprite& sprite)
 {
     sf::FloatRect camRect(
-        camera.getCenter().x - WIDTH / 2.f,
-        camera.getCenter().y - HEIGHT / 2.f,
+        static_cast<float>(view.getCenter().x - WIDTH / 2.f + renderOrigin),
+        view.getCenter().y - HEIGHT / 2.f,
         WIDTH,
         HEIGHT
     );
     return sprite.getGlobalBounds().intersects(camRect);
 }
 
+void Game::setQuality(float density, int parallaxLayers, bool smoothTextures)
+{
+    propDensity = density;
+    visibleTrees = static_cast<size_t>(treesProp.size() * propDensity);
+    visibleLeaves = static_cast<size_t>(leavesProp.size() * propDensity);
+    bg.setVisibleLayers(parallaxLayers);
+    bg.setSmooth(smoothTextures);
+    BGground.setSmooth(smoothTextures);
+}
+
+// same seed, so the level itself is untouched
 void Game::reset()
 {
-    player.hitbox.setPosition(300.f, 300.f);
-    player.velY = 0.f;
-    player.onGround = false;
-    player.currentState = Player::IDLE;
-    player.currentFrame = 0;
-    player.sprite.setTexture(player.tIdle);
-    player.sprite.setTextureRect(IntRect(0, 0, player.frameW, player.frameH));
-    camera.setCenter(WIDTH / 2.f, HEIGHT / 2.f);
-    syncRunSound();
+    restore(startState);
+    rewind.clear();
 }
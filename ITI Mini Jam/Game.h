@@ -1,49 +1,134 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <string>
 #include <vector>
+#include "AabbSet.h"
+#include "AnimationSystem.h"
 #include "CollisionManager.h"
+#include "CollisionMask.h"
+#include "InputBuffer.h"
+#include "LevelArena.h"
+#include "LevelGenerator.h"
 #include "Obstacle.h"
 #include "ParallaxBackground.h"
 #include "Platform.h"
 #include "Player.h"
+#include "RenderStats.h"
 #include "SoundManager.h"
+#include "TileGrid.h"
+#include "WorldState.h"
 
 
 using namespace sf;
 
+// Everything the render thread needs from one simulation tick. Plain
+// data, copied whole through the SimThread's triple buffer.
+struct WorldSnapshot {
+    static const int MAX_LAYERS = WorldState::MAX_LAYERS;
+
+    unsigned tick = 0;          // input tick the state belongs to
+    bool died = false;
+    double originX = 0.0;       // level x of the positions below
+    sf::Vector2f cameraCenter;
+    const sf::Texture* playerTexture = nullptr;
+    sf::IntRect playerRect;
+    sf::Vector2f playerPosition, playerScale;
+    float bgOffsets[MAX_LAYERS] = {};
+};
+
 class Game {
 public:
+    AnimationSystem animations;
     Player player;
     ParallaxBackground bg;
     ParallaxBackground BGground;
 
-    std::vector<Platform> platforms;
-    std::vector<Obstacle> obstacles;
+    // level entities live in pools carved from one arena, a rebuild takes
+    // the same objects back instead of going back to the heap
+    static const int MAX_PLATFORMS = LevelLayout::MAX_PLATFORMS;
+    static const int MAX_OBSTACLES = LevelLayout::MAX_OBSTACLES;
+    static const int NUM_PROPS = 5000;
+    LevelArena arena;
+    ObjectPool<Platform> platforms;
+    ObjectPool<Obstacle> obstacles;
+    AabbSet hazards;    // obstacle bounds, what the player is tested against first
+    std::vector<uint32_t> hazardHits;   // query() result, sized with hazards
+    sf::Texture spikeTexture;
+    CollisionMask spikeMask;            // then the spike art's opaque pixels
     Platform ground;
-    sf::View camera;
+    // optional tile terrain: pits, stairs and slopes at the start of the
+    // level, `ground` only covers what's right of it
+    bool tileTerrain = false;
+    TileGrid terrain;
+    sf::VertexArray terrainMesh;
+    sf::View camera;    // simulation side
+    sf::View view;      // render side, from the last applied snapshot
 
     std::vector<Texture> propTextures;
-    std::vector<Sprite> treesProp;
-    std::vector<Sprite> leavesProp;
+    ObjectPool<Sprite> treesProp;
+    ObjectPool<Sprite> leavesProp;
+    float propDensity = 1.f;
+    size_t visibleTrees = 0, visibleLeaves = 0;  // props are in random order, draw a prefix
+    unsigned levelSeed;
+    Rng rng;
+
+    // restart goes back to the state right after the level was built,
+    // holding rewind walks back through the last REWIND_SECONDS of ticks
+    static const int REWIND_SECONDS = 10;
+    WorldState startState;
+    RewindBuffer rewind;
 
     float WIDTH, HEIGHT;
-    float WORLD_LEFT = 0.f;
+    float WORLD_LEFT = 0.f;     // level coordinates
     float WORLD_RIGHT;
 
+    // Floating origin. Level entities stay where buildLevel put them; the
+    // player, the camera and everything collided against are relative to
+    // originX, which moves in REBASE_STEP steps once the player is more
+    // than REBASE_DISTANCE from it, so floats stay precise along the whole
+    // level. The renderer draws the level shifted by the snapshot's origin.
+    static constexpr float REBASE_DISTANCE = 16384.f;
+    static constexpr float REBASE_STEP = 4096.f;
+    double originX = 0.0;
+    double renderOrigin = 0.0;  // render side, from the last applied snapshot
+    float terrainLeft = 0.f;    // level x of the tile terrain
+
     SoundManager* soundMgr = nullptr;
 
-    Game(float W, float H, SoundManager* sm = nullptr);
+    Game(float W, float H, SoundManager* sm = nullptr, bool tileTerrain = false);
+    ~Game();
+
+    // textures the game owns (player, props, parallax), for prefetching
+    static std::vector<std::string> assets();
 
-    // returns true if player died this frame
-    bool update(float dt);
-    void draw(sf::RenderWindow& window);
+    // simulation side, runs on the SimThread
+    // returns true if player died this tick
+    bool update(float dt, InputBuffer& input);
+    void publish(WorldSnapshot& out) const;
     void reset();
-    const sf::View& getCamera() const { return camera; }
+    void capture(WorldState& out) const;
+    void restore(const WorldState& state);
+
+    // render side: takes the moving state from a snapshot, then draws the
+    // world with whatever view is set on the target
+    void applySnapshot(const WorldSnapshot& snap);
+    void draw(DrawTarget& target);
+    void setQuality(float propDensity, int parallaxLayers, bool smoothTextures);
+    const sf::View& getCamera() const { return view; }
+    // run progress for the HUD, from the last applied snapshot
+    static constexpr float PIXELS_PER_METER = 64.f;
+    int distance() const;       // meters from the start
+    int hazardsCleared() const;
 
 private:
+    void buildLevel();
+    void setOrigin(double x);
+    void rebase(float shift);
+    void buildTerrainMesh(int groundRow);
     void syncRunSound();
     bool checkObstacleCollision();
+    bool fellOutOfWorld() const;
     bool isVisible(const sf::Sprite& sprite);
 };
 
@@ -1,19 +1,24 @@
 #include "GameOverScreen.h"
 
-#include <iostream>
+#include "MemoryTracker.h"
 
 using namespace sf;
 using namespace std;
 
+vector<string> GameOverScreen::assets()
+{
+    return { "Assets/Fonts/MyFont.ttf" };
+}
+
 GameOverScreen::GameOverScreen(float width, float height)
 {
+    MemoryScope scope(MemCategory::UI);
     overlay.setSize({ width, height });
     overlay.setFillColor(Color(0, 0, 0, 180));
 
-    if (!font.loadFromFile("Assets/Fonts/MyFont.ttf"))
-        cerr << "Warning: MyFont.ttf not found for GameOver screen\n";
+    font = &resources.font("Assets/Fonts/MyFont.ttf");
 
-    title.setFont(font);
+    title.setFont(*font);
     title.setCharacterSize(64);
     title.setString("Game Over");
     title.setFillColor(Color::White);
@@ -23,46 +28,51 @@ GameOverScreen::GameOverScreen(float width, float height)
 
     restartButton = UIButton({ 250.f, 80.f }, { width / 2.f, height / 2.f + 40.f }, Color(200, 200, 200, 230));
 
-    restartLabel.setFont(font);
+    restartLabel.setFont(*font);
     restartLabel.setCharacterSize(28);
     restartLabel.setFillColor(Color::Black);
     restartLabel.setString("Restart");
     FloatRect lb = restartLabel.getLocalBounds();
     restartLabel.setOrigin(lb.width / 2.f, lb.height / 2.f);
     restartLabel.setPosition(restartButton.rect.getPosition().x, restartButton.rect.getPosition().y - 6.f);
+
+    menuButton = UIButton({ 250.f, 80.f }, { width / 2.f, height / 2.f + 140.f }, Color(200, 200, 200, 230));
+
+    menuLabel.setFont(*font);
+    menuLabel.setCharacterSize(28);
+    menuLabel.setFillColor(Color::Black);
+    menuLabel.setString("Menu");
+    FloatRect mb = menuLabel.getLocalBounds();
+    menuLabel.setOrigin(mb.width / 2.f, mb.height / 2.f);
+    menuLabel.setPosition(menuButton.rect.getPosition().x, menuButton.rect.getPosition().y - 6.f);
+
+    layer.create(static_cast<unsigned>(width), static_cast<unsigned>(height));
 }
 
-bool GameOverScreen::update(RenderWindow& window, const Event& ev)
+GameOverScreen::Choice GameOverScreen::update(RenderWindow& window, const Event& ev)
 {
     if (ev.type == Event::MouseButtonPressed && ev.mouseButton.button == Mouse::Left) {
-        Vector2i mpPixels = Mouse::getPosition(window);
-        Vector2f mpWorld = window.mapPixelToCoords(mpPixels, window.getView());
-        if (restartButton.contains(Vector2i(static_cast<int>(mpWorld.x), static_cast<int>(mpWorld.y)))) {
-            return true;
-        }
+        // the layout is in screen space, relative to the view's top-left corner
+        const View& view = window.getView();
+        Vector2f mp = window.mapPixelToCoords(Mouse::getPosition(window), view) - (view.getCenter() - view.getSize() / 2.f);
+        Vector2i p(static_cast<int>(mp.x), static_cast<int>(mp.y));
+        if (restartButton.contains(p)) return Restart;
+        if (menuButton.contains(p)) return BackToMenu;
     }
-    return false;
+    return None;
 }
 
-void GameOverScreen::draw(RenderWindow& window, const View& view)
+void GameOverScreen::draw(DrawTarget& target, const View& view)
 {
-    Vector2f size = view.getSize();
-    Vector2f center = view.getCenter();
-
-    overlay.setSize(size);
-    overlay.setOrigin(size.x / 2.f, size.y / 2.f);
-    overlay.setPosition(center);
-
-    title.setPosition(center.x, center.y - 120.f);
-    restartButton.rect.setPosition(center.x, center.y + 40.f);
-
-    FloatRect lb = restartLabel.getLocalBounds();
-    restartLabel.setOrigin(lb.width / 2.f, lb.height / 2.f);
-    restartLabel.setPosition(restartButton.rect.getPosition().x, restartButton.rect.getPosition().y - 6.f);
-
-    window.draw(overlay);
-    window.draw(title);
-    restartButton.draw(window);
-    window.draw(restartLabel);
+    DrawScope scope(DrawCategory::UI);
+    layer.track(restartButton.dirty);
+    layer.track(menuButton.dirty);
+    layer.draw(target, [this](DrawTarget& cached, const RenderStates& states) {
+        cached.draw(overlay, states);
+        cached.draw(title, states);
+        restartButton.draw(cached, states);
+        cached.draw(restartLabel, states);
+        menuButton.draw(cached, states);
+        cached.draw(menuLabel, states);
+    }, view.getCenter() - view.getSize() / 2.f);
 }
-
@@ -1,22 +1,33 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
 
+#include "ResourceCache.h"
 #include "UI.h"
 
 class GameOverScreen
 {
 public:
+    enum Choice { None, Restart, BackToMenu };
+
     GameOverScreen(float width, float height);
 
-    bool update(sf::RenderWindow& window, const sf::Event& ev);
-    void draw(sf::RenderWindow& window, const sf::View& view);
+    static std::vector<std::string> assets();
+
+    Choice update(sf::RenderWindow& window, const sf::Event& ev);
+    void draw(DrawTarget& target, const sf::View& view);
 
 private:
+    ResourceSet resources{ MemCategory::UI };
     sf::RectangleShape overlay;
-    sf::Font font;
+    const sf::Font* font;
     sf::Text title;
     UIButton restartButton;
     sf::Text restartLabel;
+    UIButton menuButton;
+    sf::Text menuLabel;
+    CachedLayer layer;  // the whole screen, laid out in screen space
 };
 
@@ -0,0 +1,126 @@
+#include "Hud.h"
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    // `value` with `decimals` digits after the point, returns the length
+    int formatInt(char* out, int value, int decimals)
+    {
+        char digits[12];
+        unsigned v = value < 0 ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v || n <= decimals);
+
+        int len = 0;
+        if (value < 0) out[len++] = '-';
+        while (n > 0) {
+            if (n == decimals) out[len++] = '.';
+            out[len++] = digits[--n];
+        }
+        return len;
+    }
+
+    int append(char* out, int len, const char* s)
+    {
+        while (*s) out[len++] = *s++;
+        return len;
+    }
+}
+
+Hud::Hud(float width)
+    : vertices(Triangles, FIELD_COUNT * FIELD_CHARS * 6)
+{
+    const Font& font = resources.font("Assets/Fonts/MyFont.ttf");
+    for (char c = ' '; c <= '~'; c++) {
+        const sf::Glyph& g = font.getGlyph(static_cast<Uint32>(c), CHAR_SIZE, false);
+        glyphs[c - ' '] = { g.bounds, FloatRect(g.textureRect), g.advance };
+    }
+    // all glyphs are in, the page won't move anymore
+    atlas = &font.getTexture(CHAR_SIZE);
+
+    const float margin = 20.f, line = font.getLineSpacing(CHAR_SIZE);
+    fields[Distance] = { Vector2f(margin, margin + line), false, "DIST ", "M", 0 };
+    fields[Score] = { Vector2f(margin, margin + 2.f * line), false, "SCORE ", "", 0 };
+    fields[Fps] = { Vector2f(width - margin, margin + line), true, "FPS ", "", 0 };
+    fields[FrameTime] = { Vector2f(width - margin, margin + 2.f * line), true, "", " MS", 1 };
+
+    for (int i = 0; i < FIELD_COUNT; i++) set(static_cast<FieldId>(i), 0);
+}
+
+vector<string> Hud::assets()
+{
+    return { "Assets/Fonts/MyFont.ttf" };
+}
+
+void Hud::setDistance(int meters)
+{
+    set(Distance, meters);
+}
+
+void Hud::setScore(int score)
+{
+    set(Score, score);
+}
+
+void Hud::addFrame(float dt)
+{
+    // frames after waiting for events have no time of their own
+    if (dt <= 0.f) return;
+    frameTime += dt;
+    frames++;
+    if (frameTime < AVERAGE_SECONDS) return;
+
+    set(Fps, static_cast<int>(frames / frameTime + 0.5f));
+    set(FrameTime, static_cast<int>(frameTime / frames * 10000.f + 0.5f));  // tenths of ms
+    frameTime = 0.f;
+    frames = 0;
+}
+
+void Hud::set(FieldId id, int value)
+{
+    Field& f = fields[id];
+    if (f.shown && f.value == value) return;
+    f.value = value;
+    f.shown = true;
+
+    char text[FIELD_CHARS];
+    int len = append(text, 0, f.label);
+    len += formatInt(text + len, value, f.decimals);
+    len = append(text, len, f.suffix);
+
+    float width = 0.f;
+    for (int i = 0; i < len; i++) width += glyphs[text[i] - ' '].advance;
+    float x = f.alignRight ? f.pen.x - width : f.pen.x;
+
+    Vertex* quad = &vertices[id * FIELD_CHARS * 6];
+    for (int i = 0; i < FIELD_CHARS; i++, quad += 6) {
+        if (i >= len) {
+            for (int v = 0; v < 6; v++) quad[v].position = Vector2f();
+            continue;
+        }
+        const Glyph& g = glyphs[text[i] - ' '];
+        float left = x + g.bounds.left, top = f.pen.y + g.bounds.top;
+        float right = left + g.bounds.width, bottom = top + g.bounds.height;
+        float u0 = g.uv.left, v0 = g.uv.top, u1 = u0 + g.uv.width, v1 = v0 + g.uv.height;
+
+        quad[0] = Vertex(Vector2f(left, top), Color::White, Vector2f(u0, v0));
+        quad[1] = Vertex(Vector2f(right, top), Color::White, Vector2f(u1, v0));
+        quad[2] = Vertex(Vector2f(left, bottom), Color::White, Vector2f(u0, v1));
+        quad[3] = quad[2];
+        quad[4] = quad[1];
+        quad[5] = Vertex(Vector2f(right, bottom), Color::White, Vector2f(u1, v1));
+        x += g.advance;
+    }
+}
+
+void Hud::draw(DrawTarget& target) const
+{
+    DrawScope scope(DrawCategory::UI);
+    RenderStates states;
+    states.texture = atlas;
+    target.draw(vertices, states);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+#include "RenderStats.h"
+#include "ResourceCache.h"
+
+// In-game HUD: distance and score top left, FPS and frame time top right.
+// The glyphs it needs are baked from the font once; after that every
+// field owns a fixed slice of one vertex array and numbers are formatted
+// into a stack buffer, so updating and drawing it never allocates. A
+// field's quads are only rewritten when its value changes, the whole HUD
+// is one draw call.
+class Hud {
+public:
+    explicit Hud(float width);
+
+    static std::vector<std::string> assets();
+
+    void setDistance(int meters);
+    void setScore(int score);
+    // averaged, the shown FPS and frame time change a few times per second
+    void addFrame(float dt);
+
+    void draw(DrawTarget& target) const;
+
+private:
+    static const unsigned CHAR_SIZE = 28;
+    static const int FIELD_CHARS = 24;      // label, sign, 10 digits, point, suffix
+    static constexpr float AVERAGE_SECONDS = 0.25f;
+
+    enum FieldId { Distance, Score, Fps, FrameTime, FIELD_COUNT };
+
+    struct Glyph {
+        sf::FloatRect bounds;   // relative to the pen on the baseline
+        sf::FloatRect uv;
+        float advance;
+    };
+
+    struct Field {
+        sf::Vector2f pen;       // baseline start, or end if alignRight
+        bool alignRight;
+        const char* label;
+        const char* suffix;
+        int decimals;
+        int value = 0;
+        bool shown = false;
+    };
+
+    void set(FieldId id, int value);
+
+    ResourceSet resources{ MemCategory::UI };
+    const sf::Texture* atlas = nullptr;
+    Glyph glyphs['~' - ' ' + 1];
+    Field fields[FIELD_COUNT];
+    sf::VertexArray vertices;   // 6 per char, unused chars collapsed to a point
+    float frameTime = 0.f;
+    int frames = 0;
+};
@@ -0,0 +1,111 @@
+#include "InputBuffer.h"
+
+#include "LatencyProbe.h"
+
+using namespace sf;
+
+InputBuffer::InputBuffer()
+{
+    clock.restart();
+}
+
+bool InputBuffer::mapKey(Keyboard::Key key, Action& out)
+{
+    switch (key) {
+    case Keyboard::A: case Keyboard::Left:  out = Action::Left;  return true;
+    case Keyboard::D: case Keyboard::Right: out = Action::Right; return true;
+    case Keyboard::Space: case Keyboard::W: case Keyboard::Up: out = Action::Jump; return true;
+    case Keyboard::R: out = Action::Rewind; return true;
+    default: return false;
+    }
+}
+
+void InputBuffer::push(Action a, bool pressed)
+{
+    int t0 = tail.load(std::memory_order_relaxed);
+    int next = (t0 + 1) % CAPACITY;
+    if (next == head.load(std::memory_order_acquire)) return; // full, drop the newest event
+
+    float t = now();
+    int id = probe ? probe->onInput(static_cast<int>(a), pressed, t) : -1;
+    events[t0] = { a, pressed, t, id };
+    tail.store(next, std::memory_order_release);
+}
+
+void InputBuffer::handleEvent(const Event& e)
+{
+    if (e.type == Event::KeyPressed || e.type == Event::KeyReleased) {
+        Keyboard::Key key = e.key.code;
+        if (key < 0 || key >= Keyboard::KeyCount) return;
+
+        bool pressed = e.type == Event::KeyPressed;
+        if (keyDown[key] == pressed) return; // key repeat or stray release
+        keyDown[key] = pressed;
+
+        Action a;
+        if (mapKey(key, a)) push(a, pressed);
+    }
+    else if (e.type == Event::LostFocus) {
+        // we never see the releases of keys held while unfocused
+        for (int k = 0; k < Keyboard::KeyCount; k++) {
+            if (!keyDown[k]) continue;
+            keyDown[k] = false;
+            Action a;
+            if (mapKey(static_cast<Keyboard::Key>(k), a)) push(a, false);
+        }
+    }
+}
+
+void InputBuffer::beginTick()
+{
+    tickTime = now();
+    tickCount++;
+    for (bool& p : pressedThisTick) p = false;
+
+    int h = head.load(std::memory_order_relaxed);
+    int end = tail.load(std::memory_order_acquire);
+    while (h != end) {
+        const InputEvent& ev = events[h];
+        int a = static_cast<int>(ev.action);
+        if (probe) probe->onConsumed(ev.probeId, tickCount, tickTime);
+
+        if (ev.pressed) {
+            heldCount[a]++;
+            pressedThisTick[a] = true;
+            if (ev.action == Action::Jump) lastJumpPress = ev.time;
+        }
+        else if (heldCount[a] > 0) {
+            heldCount[a]--;
+        }
+
+        h = (h + 1) % CAPACITY;
+    }
+    head.store(h, std::memory_order_release);
+}
+
+bool InputBuffer::isHeld(Action a) const
+{
+    return heldCount[static_cast<int>(a)] > 0;
+}
+
+bool InputBuffer::wasPressed(Action a) const
+{
+    return pressedThisTick[static_cast<int>(a)];
+}
+
+bool InputBuffer::jumpBuffered(float window) const
+{
+    return lastJumpPress >= 0.f && tickTime - lastJumpPress <= window;
+}
+
+bool InputBuffer::consumeJump(float window)
+{
+    if (!jumpBuffered(window)) return false;
+    lastJumpPress = -1.f;
+    return true;
+}
+
+float InputBuffer::now() const
+{
+    return clock.getElapsedTime().asSeconds();
+}
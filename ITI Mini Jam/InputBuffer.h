@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+
+class LatencyProbe;
+
+// Gameplay actions, several keys can map to the same action
+enum class Action { Left, Right, Jump, Rewind, Count };
+
+struct InputEvent {
+    Action action;
+    bool pressed;
+    float time;     // seconds on the InputBuffer clock
+    int probeId;    // LatencyProbe sample, -1 when not measured
+};
+
+// Records key presses/releases from the pollEvent loop with a timestamp
+// and hands them to the simulation once per tick. Replaces polling
+// sf::Keyboard so taps shorter than a frame are never lost.
+// handleEvent and beginTick may run on different threads (one each).
+class InputBuffer {
+public:
+    static const int CAPACITY = 64;
+
+    LatencyProbe* probe = nullptr;
+    unsigned tickCount = 0;
+
+    InputBuffer();
+
+    // called for every event from the window's pollEvent loop
+    void handleEvent(const sf::Event& e);
+
+    // drains everything recorded since the last tick (call once per tick)
+    void beginTick();
+
+    bool isHeld(Action a) const;
+    // pressed at least once during this tick (even if already released)
+    bool wasPressed(Action a) const;
+
+    // true if jump was pressed within the last `window` seconds
+    bool jumpBuffered(float window) const;
+    // same, and consumes it
+    bool consumeJump(float window);
+
+    float now() const;
+
+private:
+    InputEvent events[CAPACITY];
+    std::atomic<int> head{ 0 }, tail{ 0 };     // head: consumer, tail: producer
+
+    bool keyDown[sf::Keyboard::KeyCount] = {};
+    int heldCount[static_cast<int>(Action::Count)] = {};
+    bool pressedThisTick[static_cast<int>(Action::Count)] = {};
+
+    float tickTime = 0.f;
+    float lastJumpPress = -1.f;     // < 0 when there is no buffered jump
+    sf::Clock clock;
+
+    void push(Action a, bool pressed);
+    static bool mapKey(sf::Keyboard::Key key, Action& out);
+};
@@ -0,0 +1,115 @@
+#include "LatencyProbe.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+static const char* actionNames[] = { "left", "right", "jump", "rewind" };
+
+void LatencyProbe::open(const string& file, const string& configLabel)
+{
+    path = file;
+    label = configLabel;
+    enabled = true;
+    samples.reserve(4096);
+    awaitingDisplay.reserve(64);
+}
+
+int LatencyProbe::onInput(int action, bool pressed, float time)
+{
+    if (!enabled) return -1;
+    lock_guard<mutex> guard(lock);
+    Sample s;
+    s.action = action;
+    s.pressed = pressed;
+    s.input = time;
+    samples.push_back(s);
+    return static_cast<int>(samples.size()) - 1;
+}
+
+void LatencyProbe::onConsumed(int id, unsigned tick, float time)
+{
+    if (!enabled || id < 0) return;
+    lock_guard<mutex> guard(lock);
+    samples[id].consumed = time;
+    samples[id].tick = tick;
+    awaitingDisplay.push_back(id);
+}
+
+void LatencyProbe::onDisplay(unsigned frame, unsigned tick, float time)
+{
+    if (!enabled) return;
+    lock_guard<mutex> guard(lock);
+    // consumed by a tick that is not on screen yet: keep waiting
+    size_t kept = 0;
+    for (int id : awaitingDisplay) {
+        if (samples[id].tick > tick) {
+            awaitingDisplay[kept++] = id;
+            continue;
+        }
+        samples[id].displayed = time;
+        samples[id].frame = frame;
+    }
+    awaitingDisplay.resize(kept);
+}
+
+// prints p50/p99 and a 1ms-bucket histogram of the given latencies (ms)
+static void writeHistogram(ofstream& out, const string& name, vector<float> ms)
+{
+    out << "\n## " << name << " (" << ms.size() << " events)\n";
+    if (ms.empty()) return;
+
+    sort(ms.begin(), ms.end());
+    auto pct = [&](float p) { return ms[static_cast<size_t>(p * (ms.size() - 1))]; };
+    out << "min " << ms.front() << " ms, p50 " << pct(0.5f) << " ms, p99 " << pct(0.99f)
+        << " ms, max " << ms.back() << " ms\n";
+
+    const int BUCKETS = 50;
+    int counts[BUCKETS + 1] = {};
+    for (float v : ms) counts[min(static_cast<int>(v), BUCKETS)]++;
+
+    for (int i = 0; i <= BUCKETS; i++) {
+        if (!counts[i]) continue;
+        if (i == BUCKETS) out << setw(6) << (">=" + to_string(BUCKETS));
+        else out << setw(3) << i << "-" << setw(2) << i + 1;
+        out << " ms | " << setw(5) << counts[i] << " " << string(min(counts[i], 60), '#') << "\n";
+    }
+}
+
+bool LatencyProbe::writeReport() const
+{
+    if (!enabled) return false;
+    lock_guard<mutex> guard(lock);
+
+    ofstream out(path);
+    if (!out) {
+        cerr << "Warning: can't write latency report " << path << "\n";
+        return false;
+    }
+
+    out << fixed << setprecision(2);
+    out << "# input latency report: " << label << "\n";
+    out << "# id action edge input_s tick frame input_to_tick_ms input_to_display_ms\n";
+
+    vector<float> toTick, toDisplay;
+    for (size_t i = 0; i < samples.size(); i++) {
+        const Sample& s = samples[i];
+        if (s.displayed < 0.f) continue; // still in flight when we quit
+
+        float tickMs = (s.consumed - s.input) * 1000.f;
+        float displayMs = (s.displayed - s.input) * 1000.f;
+        toTick.push_back(tickMs);
+        toDisplay.push_back(displayMs);
+
+        out << i << " " << actionNames[s.action] << " " << (s.pressed ? "down" : "up") << " "
+            << setprecision(4) << s.input << setprecision(2) << " " << s.tick << " " << s.frame
+            << " " << tickMs << " " << displayMs << "\n";
+    }
+
+    writeHistogram(out, "input -> consuming tick", toTick);
+    writeHistogram(out, "input -> display", toDisplay);
+    return true;
+}
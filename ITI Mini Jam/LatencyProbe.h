@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Instrumentation mode: follows each input event from the pollEvent loop
+// to the tick that consumes it and to the first window.display() after
+// that tick, then writes per-event latency and p50/p99 histograms.
+// Input and display happen on the render thread, consumption on the
+// simulation thread.
+class LatencyProbe {
+public:
+    bool enabled = false;
+
+    // enables the probe; `label` describes the config under test (vsync, limiter...)
+    void open(const std::string& path, const std::string& label);
+
+    // all times are seconds on the InputBuffer clock
+    int onInput(int action, bool pressed, float time);
+    void onConsumed(int id, unsigned tick, float time);
+    // `tick`: newest tick whose result is on screen now
+    void onDisplay(unsigned frame, unsigned tick, float time);
+
+    bool writeReport() const;
+
+private:
+    struct Sample {
+        int action;
+        bool pressed;
+        float input, consumed = -1.f, displayed = -1.f;
+        unsigned tick = 0, frame = 0;
+    };
+
+    std::vector<Sample> samples;
+    std::vector<int> awaitingDisplay;
+    std::string path, label;
+    mutable std::mutex lock;
+};
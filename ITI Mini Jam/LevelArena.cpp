@@ -0,0 +1,32 @@
+#include "LevelArena.h"
+
+#include <cstdint>
+
+LevelArena::LevelArena(size_t capacity)
+    : buffer(new char[capacity]), size(capacity)
+{
+}
+
+LevelArena::~LevelArena()
+{
+    delete[] buffer;
+}
+
+void* LevelArena::allocate(size_t bytes, size_t align)
+{
+    uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+    uintptr_t p = (base + offset + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    size_t newOffset = static_cast<size_t>(p - base) + bytes;
+
+    assert(newOffset <= size && "LevelArena out of memory");
+    if (newOffset > size) throw std::bad_alloc();
+
+    offset = newOffset;
+    return reinterpret_cast<void*>(p);
+}
+
+void LevelArena::rewind(size_t to)
+{
+    assert(to <= offset);
+    offset = to;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Bump allocator for level-lifetime data. One heap block is taken up
+// front and rewound instead of freeing anything.
+class LevelArena {
+public:
+    explicit LevelArena(size_t capacity);
+    ~LevelArena();
+
+    LevelArena(const LevelArena&) = delete;
+    LevelArena& operator=(const LevelArena&) = delete;
+
+    void* allocate(size_t bytes, size_t align);
+    // everything allocated after `to` becomes invalid
+    void rewind(size_t to = 0);
+
+    size_t used() const { return offset; }
+    size_t capacity() const { return size; }
+
+private:
+    char* buffer;
+    size_t size;
+    size_t offset = 0;
+};
+
+// Fixed-capacity typed pool carved out of a LevelArena. clear() destroys
+// the objects but keeps the storage so the next level reuses it;
+// recycle() keeps the objects too, so a rebuild can acquire() them back
+// and only reset them (SFML shapes own heap buffers, constructing them
+// again would allocate).
+template<class T>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { clear(); }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // takes fresh storage from `arena`, the pool must be empty
+    void reserve(LevelArena& arena, size_t capacity)
+    {
+        assert(built == 0);
+        items = static_cast<T*>(arena.allocate(sizeof(T) * capacity, alignof(T)));
+        cap = capacity;
+    }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        assert(count == built && "ObjectPool has recycled objects, acquire() them");
+        assert(count < cap && "ObjectPool capacity exceeded");
+        T* p = new (items + count) T(std::forward<Args>(args)...);
+        count++;
+        built++;
+        return *p;
+    }
+
+    // a recycled object as it was left, or a new one from `args`
+    template<class... Args>
+    T& acquire(Args&&... args)
+    {
+        if (count < built) return items[count++];
+        return emplace_back(std::forward<Args>(args)...);
+    }
+
+    // empties the pool but keeps its objects alive for acquire()
+    void recycle() { count = 0; }
+
+    void clear()
+    {
+        for (size_t i = 0; i < built; i++) items[i].~T();
+        count = built = 0;
+    }
+
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    T& back() { return items[count - 1]; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+
+private:
+    T* items = nullptr;
+    size_t count = 0, cap = 0;
+    size_t built = 0;       // constructed objects, past `count` after recycle()
+};
@@ -0,0 +1,145 @@
+#include "LevelGenerator.h"
+
+#include "WorldState.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    void addPlatform(LevelLayout& l, float x, float y, float w, float h)
+    {
+        if (l.platformCount < LevelLayout::MAX_PLATFORMS)
+            l.platforms[l.platformCount++] = FloatRect(x, y, w, h);
+    }
+
+    // obstacles are placed by their center, like Obstacle
+    void addObstacle(LevelLayout& l, float cx, float cy, float w, float h)
+    {
+        if (l.obstacleCount < LevelLayout::MAX_OBSTACLES)
+            l.obstacles[l.obstacleCount++] = FloatRect(cx - w / 2.f, cy - h / 2.f, w, h);
+    }
+}
+
+void LevelGenerator::generate(uint32_t seed, float worldWidth, float height, LevelLayout& out)
+{
+    out = LevelLayout();
+    out.ground = FloatRect(50.f, height - 200.f, worldWidth - 100.f, 200.f);
+
+    addPlatform(out, 800.f, height - 250.f, 300.f, 40.f);
+    addPlatform(out, 1400.f, height - 350.f, 250.f, 40.f);
+    addPlatform(out, 2000.f, height - 200.f, 400.f, 40.f);
+
+    addObstacle(out, 1100.f, height - 220.f, 90.f, 140.f);
+    addObstacle(out, 1750.f, height - 230.f, 90.f, 140.f);
+    addObstacle(out, 2400.f, height - 220.f, 90.f, 140.f);
+
+    // its own stream, so props drawn from the level seed don't shift
+    // whenever the generator changes
+    Rng rng = Rng::seeded(seed ^ 0x5EC7105Eu);
+    float x = 2900.f;
+    const float limit = worldWidth - 1000.f;
+
+    while (x < limit && (out.platformCount < LevelLayout::MAX_PLATFORMS || out.obstacleCount < LevelLayout::MAX_OBSTACLES))
+    {
+        float roll = rng.uniform();
+        if (roll < 0.45f) {
+            // lone obstacle
+            addObstacle(out, x, height - 220.f - rng.uniform() * 15.f, 90.f, 140.f);
+            x += 90.f;
+        }
+        else if (roll < 0.75f) {
+            // raised platform to jump onto
+            float w = 250.f + rng.uniform() * 150.f;
+            addPlatform(out, x, height - 250.f - rng.uniform() * 100.f, w, 40.f);
+            x += w;
+        }
+        else {
+            // platform with an obstacle right behind it
+            float w = 250.f + rng.uniform() * 150.f;
+            addPlatform(out, x, height - 250.f - rng.uniform() * 100.f, w, 40.f);
+            x += w + 250.f + rng.uniform() * 100.f;
+            addObstacle(out, x, height - 220.f, 90.f, 140.f);
+            x += 90.f;
+        }
+        x += 450.f + rng.uniform() * 450.f;
+    }
+    out.endX = min(x, limit);
+}
+
+void LevelGenerator::generateTerrain(uint32_t seed, const LevelLayout& layout, TileGrid& out)
+{
+    const float tile = 25.f;
+    const int rowsAbove = 6;                    // room for raised terrain
+    const int groundRow = rowsAbove;
+    const int rowsBelow = static_cast<int>(ceil(layout.ground.height / tile));
+    const float right = layout.endX + 1000.f;
+    const int cols = static_cast<int>(ceil((right - layout.ground.left) / tile));
+
+    out.create(layout.ground.left, layout.ground.top - rowsAbove * tile, tile, cols, rowsAbove + rowsBelow);
+    out.fill(0, groundRow, cols - 1, out.rows - 1, TileGrid::Solid);
+
+    // x ranges taken by the layout (and the spawn), with room to land
+    // before and after them
+    const float margin = 150.f;
+    pair<float, float> used[LevelLayout::MAX_PLATFORMS + LevelLayout::MAX_OBSTACLES + 1];
+    size_t usedCount = 0;
+    used[usedCount++] = { layout.ground.left, 700.f };
+    for (int i = 0; i < layout.platformCount; i++)
+        used[usedCount++] = { layout.platforms[i].left - margin, layout.platforms[i].left + layout.platforms[i].width + margin };
+    for (int i = 0; i < layout.obstacleCount; i++)
+        used[usedCount++] = { layout.obstacles[i].left - margin, layout.obstacles[i].left + layout.obstacles[i].width + margin };
+    sort(used, used + usedCount);
+
+    Rng rng = Rng::seeded(seed ^ 0x7E44A1Eu);
+    float freeFrom = used[0].second;
+    for (size_t i = 1; i <= usedCount; i++)
+    {
+        float freeTo = i < usedCount ? used[i].first : layout.endX;
+        int c0 = out.colAt(freeFrom) + 1;
+        int span = out.colAt(freeTo) - c0;
+        if (i < usedCount) freeFrom = max(freeFrom, used[i].second);
+        if (span < 6) continue;
+
+        float roll = rng.uniform();
+        if (roll < 0.35f) {
+            // pit, 3-5 tiles wide, centered in the gap
+            int w = 3 + static_cast<int>(rng.next() % 3);
+            int start = c0 + (span - w) / 2;
+            out.fill(start, groundRow, start + w - 1, out.rows - 1, TileGrid::Empty);
+        }
+        else if (roll < 0.6f && span >= 18) {
+            // stairs up and down, one tile per step
+            int steps = 2 + static_cast<int>(rng.next() % 2);
+            int stepW = 2, topW = max(2, span - 2 * steps * stepW - 4);
+            topW = min(topW, 8);
+            int c = c0 + (span - (2 * steps * stepW + topW)) / 2;
+            for (int s = 1; s <= steps; s++, c += stepW)
+                out.fill(c, groundRow - s, c + stepW - 1, groundRow - 1, TileGrid::Solid);
+            out.fill(c, groundRow - steps, c + topW - 1, groundRow - 1, TileGrid::Solid);
+            c += topW;
+            for (int s = steps; s >= 1; s--, c += stepW)
+                out.fill(c, groundRow - s, c + stepW - 1, groundRow - 1, TileGrid::Solid);
+        }
+        else if (roll < 0.85f && span >= 12) {
+            // hill with 45 degree slopes
+            int h = 2 + static_cast<int>(rng.next() % 3);
+            int topW = min(span - 2 * h - 2, 6);
+            if (topW < 1) continue;
+            int c = c0 + (span - (2 * h + topW)) / 2;
+            for (int s = 0; s < h; s++, c++) {
+                out.set(c, groundRow - 1 - s, TileGrid::SlopeUp);
+                out.fill(c, groundRow - s, c, groundRow - 1, TileGrid::Solid);
+            }
+            out.fill(c, groundRow - h, c + topW - 1, groundRow - 1, TileGrid::Solid);
+            c += topW;
+            for (int s = h - 1; s >= 0; s--, c++) {
+                out.set(c, groundRow - 1 - s, TileGrid::SlopeDown);
+                out.fill(c, groundRow - s, c, groundRow - 1, TileGrid::Solid);
+            }
+        }
+    }
+}
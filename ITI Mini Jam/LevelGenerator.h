@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+
+#include "TileGrid.h"
+
+// Collision layout of a level as plain rects. Game turns it into
+// Platform/Obstacle entities, the Playtester collides against it directly.
+struct LevelLayout {
+    static const int MAX_PLATFORMS = 64;
+    static const int MAX_OBSTACLES = 64;
+
+    sf::FloatRect ground;
+    sf::FloatRect platforms[MAX_PLATFORMS];
+    sf::FloatRect obstacles[MAX_OBSTACLES];
+    int platformCount = 0;
+    int obstacleCount = 0;
+    float endX = 0.f;       // right edge of the last generated section
+};
+
+// The hand-made opening (three platforms, three obstacles) followed by
+// sections generated from the seed until the pools are full. Same seed,
+// same layout, on any thread.
+class LevelGenerator {
+public:
+    // what headless runs (Playtester, BatchSim) generate at; any fixed size
+    // works as long as every run uses the same one
+    static constexpr float HEADLESS_WIDTH = 1920.f * 10000.f;
+    static constexpr float HEADLESS_HEIGHT = 1080.f;
+
+    static void generate(uint32_t seed, float worldWidth, float height, LevelLayout& out);
+
+    // optional tile terrain for a generated layout: the ground from its left
+    // edge to past endX, with pits, stairs and slopes in the stretches the
+    // layout leaves free. Beyond the grid the layout's ground rect carries on.
+    static void generateTerrain(uint32_t seed, const LevelLayout& layout, TileGrid& out);
+};
@@ -1,130 +1,296 @@
 ﻿#include <SFML/Graphics.hpp>
 
-#include "Game.h"
-#include "Menu.h"
-#include "OptionsMenu.h"
+#include "AssetPack.h"
+#include "BatchSim.h"
+#include "DynamicResolution.h"
+#include "FlightRecorder.h"
+#include "FrameScheduler.h"
+#include "InputBuffer.h"
+#include "LatencyProbe.h"
+#include "MemoryTracker.h"
+#include "Playtester.h"
+#include "QualityGovernor.h"
 #include "RainSystem.h"
-#include "GameOverScreen.h"
+#include "RenderStats.h"
+#include "ResourceCache.h"
+#include "Scenes.h"
 #include "SoundManager.h"
+#include "StartupProfile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 using namespace sf;
+using namespace std;
+
+// numeric flag value; bad input warns and leaves `value` at its default
+template<class T>
+static void parseArg(const char* flag, const char* text, T& value)
+{
+    T parsed{};
+    const char* end = text + strlen(text);
+    auto [ptr, ec] = from_chars(text, end, parsed);
+    if (ec != errc() || ptr != end) {
+        cerr << "Warning: bad value '" << text << "' for " << flag << ", using " << value << "\n";
+        return;
+    }
+    value = parsed;
+}
 
-int main()
+int main(int argc, char* argv[])
 {
+    // --latency-log <file>: measure input-to-display latency for this run
+    // --vsync / --no-limit: pacing configs to compare with it
+    // --fps <hz>: frame rate target (default 60), --refresh <hz>: display rate vsync presents on
+    // --min-res-scale <f>: lowest world resolution scale (1 = always native)
+    // --pack-assets [file]: packs Assets/ pre-decoded into one file and exits (run after Release builds)
+    // --draw-stats <file>: per-frame draw call counters as CSV, plus the frame pacing report at exit
+    // --playtest <runs> [--seed <s>]: headless bot runs over generated levels, prints a report and exits
+    // --tile-terrain: level starts on tile terrain (pits, stairs, slopes) instead of flat ground
+    // --batch-bench <worlds>: steps that many worlds in lockstep for a few seconds, prints world-ticks/s and exits
+    // --hitch-ms <ms>: full-rate frames longer than this dump the last seconds to hitch_<n>.txt (default 50, 0 = off)
+    string latencyLog, drawStatsLog;
+    bool vsync = false, frameLimit = true, tileTerrain = false;
+    unsigned fps = 60, refresh = 60;
+    float minResScale = 0.5f;
+    int playtestRuns = 0;
+    unsigned playtestSeed = 1;
+    float hitchMs = 50.f;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--latency-log" && i + 1 < argc) latencyLog = argv[++i];
+        else if (arg == "--vsync") vsync = true;
+        else if (arg == "--no-limit") frameLimit = false;
+        else if (arg == "--fps" && i + 1 < argc) parseArg("--fps", argv[++i], fps);
+        else if (arg == "--refresh" && i + 1 < argc) parseArg("--refresh", argv[++i], refresh);
+        else if (arg == "--tile-terrain") tileTerrain = true;
+        else if (arg == "--min-res-scale" && i + 1 < argc) parseArg("--min-res-scale", argv[++i], minResScale);
+        else if (arg == "--draw-stats" && i + 1 < argc) drawStatsLog = argv[++i];
+        else if (arg == "--playtest" && i + 1 < argc) parseArg("--playtest", argv[++i], playtestRuns);
+        else if (arg == "--seed" && i + 1 < argc) parseArg("--seed", argv[++i], playtestSeed);
+        else if (arg == "--hitch-ms" && i + 1 < argc) parseArg("--hitch-ms", argv[++i], hitchMs);
+        else if (arg == "--batch-bench" && i + 1 < argc) {
+            int worlds = 64;
+            parseArg("--batch-bench", argv[++i], worlds);
+            BatchSim::benchmark(max(worlds, 1), 3.f);
+            return 0;
+        }
+        else if (arg == "--pack-assets") {
+            // the output path is optional, a following flag isn't one
+            bool hasPath = i + 1 < argc && string(argv[i + 1]).rfind("--", 0) != 0;
+            return AssetPack::build("Assets", hasPath ? argv[i + 1] : "Assets.pak") ? 0 : 1;
+        }
+    }
+
+    fps = max(fps, 1u);
+    refresh = max(refresh, 1u);
+    FlightRecorder::setThreshold(max(hitchMs, 0.f) / 1000.f);
+
+    if (playtestRuns > 0)
+        return Playtester::run(playtestRuns, playtestSeed) ? 0 : 1;
+
+    StartupProfile::start();
+
+    // pre-decoded, memory-mapped assets if the pack was built, loose files otherwise
+    if (AssetPack::open("Assets.pak"))
+        cerr << "Using Assets.pak\n";
+
+    // decode what the menu needs while the window comes up; the loads below
+    // then only upload (streamed music and run.ogg.opus load as before)
+    vector<string> startupAssets = {
+        "Assets/SFX/button_click.mp3", "Assets/SFX/jump.mp3", "Assets/SFX/landing.mp3", "Assets/SFX/rain.mp3",
+    };
+    for (auto& path : Menu::assets()) startupAssets.push_back(path);
+    AssetPack::preload(startupAssets);
+
     auto mode = VideoMode::getDesktopMode();
     float WIDTH = static_cast<float>(mode.width);
     float HEIGHT = static_cast<float>(mode.height);
 
     // Borderless fullscreen to avoid OS white flash
+    optional<StartupScope> windowStep(in_place, "window");
     RenderWindow window(mode, "ESC CTRL", Style::None);
-    window.setFramerateLimit(60);
+    window.setVerticalSyncEnabled(vsync);
+    window.setKeyRepeatEnabled(false);
 
     //  First black frame immediately
     window.clear(Color::Black);
     window.display();
+    windowStep.reset();
 
     // ---- create objects after first frame ----
+    optional<StartupScope> step(in_place, "SoundManager");
     SoundManager soundMgr;
     soundMgr.playMusic("menu", true);
 
+    step.emplace("RainSystem");
     RainSystem rain(80, WIDTH, HEIGHT);
-    Menu menu(WIDTH, HEIGHT, &soundMgr);
-    OptionsMenu options(WIDTH, HEIGHT, &soundMgr);
-    GameOverScreen gameOver(WIDTH, HEIGHT);
+    step.reset();
 
-    Game* game = nullptr;
+    // world pass resolution follows frame time, menus/overlays stay native
+    DynamicResolution worldPass(mode.width, mode.height);
+    worldPass.minScale = min(max(minResScale, 0.25f), 1.f);
 
-    enum GameState { MENU_STATE, PLAYING_STATE, OPTIONS_STATE, GAMEOVER_STATE };
-    GameState gameState = MENU_STATE;
+    // steps rain, prop density and parallax detail to hold the frame budget
+    QualityGovernor quality;
 
-    Clock dtClock;
+    InputBuffer input;
+    LatencyProbe latency;
+    if (!latencyLog.empty()) {
+        string label = string(vsync ? "vsync" : "no-vsync") + ", " + (frameLimit ? "limit " + to_string(fps) : string("no limit"));
+        latency.open(latencyLog, label);
+        input.probe = &latency;
+    }
+
+    // full rate while something moves, low rate or event-driven otherwise
+    FrameScheduler scheduler(window, frameLimit ? fps : 0);
+    scheduler.pacer.setVsync(vsync, refresh);
+    if (frameLimit) {
+        quality.targetFrameTime = 1.f / fps;
+        worldPass.targetFrameTime = 1.f / fps;
+    }
+
+    // menu, options, play and game over; only what the stack holds is resident
+    SceneStack scenes;
+    SceneContext context{ window, scenes, soundMgr, input, rain, worldPass, quality, scheduler, WIDTH, HEIGHT, tileTerrain };
+    step.emplace("Menu");
+    scenes.push([&context] { return make_unique<MenuScene>(context); });
+    scenes.commit();
+    step.reset();
+    AssetPack::finishPreload();
+
+    unsigned frameCount = 0;
+    if (!drawStatsLog.empty()) RenderStats::openLog(drawStatsLog);
+
+    // every draw goes through this so it shows up in RenderStats
+    DrawTarget screen(window);
 
     // 🔹 Fade-in overlay
     RectangleShape fadeOverlay(Vector2f(WIDTH, HEIGHT));
     fadeOverlay.setFillColor(Color::Black);
     float fadeAlpha = 255.f;      // start fully black
     float fadeSpeed = 150.f;      // alpha decrease per second
+    const float TRANSITION_FADE_SPEED = 1020.f;   // a quarter second each way
 
-    while (window.isOpen())
+    while (window.isOpen() && !scenes.empty())
     {
+        // idle frames wait for input in here
+        auto eventsBegin = chrono::steady_clock::now();
         Event e;
-        while (window.pollEvent(e))
+        while (scheduler.pollEvent(e))
         {
             if (e.type == Event::Closed ||
                 (e.type == Event::KeyPressed && e.key.code == Keyboard::Escape))
                 window.close();
 
-            if (gameState == OPTIONS_STATE) {
-                int res = options.update(window, e);
-                if (res == 1)
-                    gameState = MENU_STATE;
+            input.handleEvent(e);
+            FlightRecorder::recordEvent(e);
+
+            // hold the simulation first, it drives the run sound
+            if (e.type == Event::LostFocus) {
+                scenes.handleEvent(e);
+                soundMgr.pauseAll();
+                continue;
             }
-            else if (gameState == GAMEOVER_STATE && game) {
-                window.setView(game->getCamera());
-                if (gameOver.update(window, e)) {
-                    game->reset();
-                    gameState = PLAYING_STATE;
-                }
+            if (e.type == Event::GainedFocus) {
+                soundMgr.resumeAll();
+                scenes.handleEvent(e);
+                continue;
             }
-        }
 
-        float dt = dtClock.restart().asSeconds();
-        window.clear(Color::Black);
-
-        // --- Drawing logic ---
-        if (gameState == MENU_STATE)
-        {
-            int menuResult = menu.update(window);
-            menu.draw(window);
-
-            rain.update(dt);
-            rain.draw(window);
-
-            if (menuResult == 1) { // PLAY
-                if (!game)
-                    game = new Game(WIDTH, HEIGHT, &soundMgr);
-                gameState = PLAYING_STATE;
-            }
-            else if (menuResult == 2) { // OPTIONS
-                gameState = OPTIONS_STATE;
+            // F9: per-subsystem memory report
+            if (e.type == Event::KeyPressed && e.key.code == Keyboard::F9) {
+                MemoryTracker::report(cerr);
+                MemoryTracker::writeReport("memory_report.txt");
+                cerr << ResourceCache::residentCount() << " shared resources resident\n";
             }
-            else if (menuResult == 3) { // EXIT
-                window.close();
+            // F10: draw calls of the last frame
+            if (e.type == Event::KeyPressed && e.key.code == Keyboard::F10)
+                RenderStats::report(cerr);
+            // F11: frame pacing since the last F11
+            if (e.type == Event::KeyPressed && e.key.code == Keyboard::F11) {
+                scheduler.pacer.report(cerr);
+                scheduler.pacer.resetStats();
             }
+
+            scenes.handleEvent(e);
         }
-        else if (gameState == PLAYING_STATE && game)
-        {
-            bool died = game->update(dt);
-            game->draw(window);
-            if (died)
-                gameState = GAMEOVER_STATE;
+        FlightRecorder::addZoneTime(Zone::Events, chrono::steady_clock::now() - eventsBegin);
+
+        float dt = scheduler.beginFrame();
+        // outside of play the input is drained here, nothing reads it
+        if (!scenes.top().isSimulating()) input.beginTick();
+        RenderStats::beginFrame();
+        screen.clear(Color::Black);
+
+        // only full-rate frame times say anything about the frame budget
+        if (scheduler.steady() && quality.addFrame(scheduler.workTime())) {
+            const QualityTier& q = quality.current();
+            rain.setActiveCount(q.rainDrops);
+            scenes.setQuality(q);
         }
-        else if (gameState == OPTIONS_STATE)
+
         {
-            RectangleShape bg(Vector2f(WIDTH, HEIGHT));
-            bg.setTexture(&menu.tMenuBg);
-            window.draw(bg);
-            options.draw(window);
+            ZoneScope zone(Zone::Update);
+            scenes.update(dt);
         }
-        else if (gameState == GAMEOVER_STATE && game)
         {
-            window.setView(game->getCamera());
-            game->draw(window);
-            gameOver.draw(window, game->getCamera());
+            ZoneScope zone(Zone::Draw);
+            scenes.draw(screen);
         }
+        window.setView(window.getDefaultView());
 
-        // --- Fade-in overlay ---
-        if (fadeAlpha > 0.f)
+        // --- Fade overlay ---
+        // scene replacements fade out first, the loaders decode the next
+        // scene's assets meanwhile, and fade back in once it is up
+        if (scenes.pendingIsSlow()) {
+            fadeAlpha = min(fadeAlpha + TRANSITION_FADE_SPEED * dt, 255.f);
+            fadeSpeed = TRANSITION_FADE_SPEED;
+        }
+        else if (fadeAlpha > 0.f)
         {
             fadeAlpha -= fadeSpeed * dt;
             if (fadeAlpha < 0.f) fadeAlpha = 0.f;
+        }
+        if (fadeAlpha > 0.f)
+        {
             fadeOverlay.setFillColor(Color(0, 0, 0, static_cast<Uint8>(fadeAlpha)));
-            window.draw(fadeOverlay);
+            screen.draw(fadeOverlay);
         }
 
-        window.display();
+        {
+            ZoneScope zone(Zone::Present);
+            scheduler.present();
+        }
+        // the first menu frame is on screen, startup is over
+        if (StartupProfile::active()) StartupProfile::finish(cerr);
+        latency.onDisplay(++frameCount, scenes.top().shownTick(), input.now());
+
+        // scene changes land between frames, replacements once the screen is black
+        if (scenes.hasPending() && (!scenes.pendingIsSlow() || fadeAlpha >= 255.f)) {
+            ZoneScope zone(Zone::Transition);
+            scenes.commit();
+        }
+
+        const DrawCounters& drawn = RenderStats::runningFrame().total;
+        FlightRecorder::setCounter(Counter::DrawCalls, drawn.draws);
+        FlightRecorder::setCounter(Counter::Vertices, drawn.vertices);
+        FlightRecorder::setCounter(Counter::RainDrops, static_cast<uint32_t>(rain.activeCount));
+        FlightRecorder::endFrame(scheduler.steady());
+
+        // options and game over only change on input
+        scheduler.endFrame(fadeAlpha > 0.f || scenes.hasPending() || (!scenes.empty() && scenes.top().isAnimated()));
     }
 
-    delete game;
+    latency.writeReport();
+    if (!drawStatsLog.empty()) scheduler.pacer.report(cerr);
     return 0;
 }
@@ -0,0 +1,191 @@
+#include "MemoryTracker.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>     // _msize / malloc_usable_size
+#include <new>
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    const int COUNT = static_cast<int>(MemCategory::Count);
+    const char* names[COUNT] = { "General", "Game", "Menu", "UI", "SoundManager", "RainSystem", "ParallaxBackground" };
+
+    // plain atomics so they are usable before any constructor has run
+    atomic<size_t> heapBytes[COUNT];
+    atomic<size_t> heapPeak[COUNT];
+    atomic<size_t> textureBytes[COUNT];
+    atomic<size_t> audioBytes[COUNT];
+    atomic<size_t> totalPeak[COUNT];
+    atomic<size_t> allocations;
+
+    thread_local MemCategory currentCategory = MemCategory::General;
+    thread_local size_t threadAllocations = 0;
+
+    void raise(atomic<size_t>& peak, size_t value)
+    {
+        size_t old = peak.load(memory_order_relaxed);
+        while (value > old && !peak.compare_exchange_weak(old, value, memory_order_relaxed)) {}
+    }
+
+    void updatePeaks(int i)
+    {
+        raise(heapPeak[i], heapBytes[i].load(memory_order_relaxed));
+        raise(totalPeak[i], heapBytes[i].load(memory_order_relaxed) +
+            textureBytes[i].load(memory_order_relaxed) + audioBytes[i].load(memory_order_relaxed));
+    }
+
+    size_t textureSize(const Texture& tex) { return static_cast<size_t>(tex.getSize().x) * tex.getSize().y * 4; }
+    size_t soundSize(const SoundBuffer& buf) { return static_cast<size_t>(buf.getSampleCount()) * sizeof(Int16); }
+
+    // The pointer handed out is malloc's own: the SFML DLLs allocate and
+    // free with the stock new/delete and blocks cross that boundary both
+    // ways. Size and category ride in a trailer at the end of the block
+    // instead, stamped with a cookie; blocks without one (allocated inside
+    // a DLL) are freed untracked.
+    struct Trailer {
+        uintptr_t cookie;       // TRAILER_COOKIE ^ block address
+        size_t size;
+        MemCategory category;
+    };
+    const uintptr_t TRAILER_COOKIE = static_cast<uintptr_t>(0x6D656D7472616B21ull);
+
+    size_t usableSize(void* p)
+    {
+#ifdef _WIN32
+        return _msize(p);
+#else
+        return malloc_usable_size(p);
+#endif
+    }
+
+    void* trackedAlloc(size_t size)
+    {
+        void* p = malloc(size + sizeof(Trailer));
+        if (!p) return nullptr;
+        Trailer t = { TRAILER_COOKIE ^ reinterpret_cast<uintptr_t>(p), size, currentCategory };
+        memcpy(static_cast<char*>(p) + usableSize(p) - sizeof(Trailer), &t, sizeof(t));
+        MemoryTracker::onAlloc(t.category, size);
+        return p;
+    }
+
+    void trackedFree(void* p)
+    {
+        if (!p) return;
+        size_t usable = usableSize(p);
+        if (usable >= sizeof(Trailer)) {
+            char* at = static_cast<char*>(p) + usable - sizeof(Trailer);
+            Trailer t;
+            memcpy(&t, at, sizeof(t));
+            if (t.cookie == (TRAILER_COOKIE ^ reinterpret_cast<uintptr_t>(p))) {
+                MemoryTracker::onFree(t.category, t.size);
+                memset(at, 0, sizeof(t));   // a later DLL block at this address isn't ours
+            }
+        }
+        free(p);
+    }
+}
+
+void MemoryTracker::onAlloc(MemCategory c, size_t bytes)
+{
+    int i = static_cast<int>(c);
+    heapBytes[i].fetch_add(bytes, memory_order_relaxed);
+    allocations.fetch_add(1, memory_order_relaxed);
+    threadAllocations++;
+    updatePeaks(i);
+}
+
+void MemoryTracker::onFree(MemCategory c, size_t bytes)
+{
+    heapBytes[static_cast<int>(c)].fetch_sub(bytes, memory_order_relaxed);
+}
+
+void MemoryTracker::addTexture(MemCategory c, const Texture& tex)
+{
+    int i = static_cast<int>(c);
+    textureBytes[i].fetch_add(textureSize(tex), memory_order_relaxed);
+    updatePeaks(i);
+}
+
+void MemoryTracker::removeTexture(MemCategory c, const Texture& tex)
+{
+    textureBytes[static_cast<int>(c)].fetch_sub(textureSize(tex), memory_order_relaxed);
+}
+
+void MemoryTracker::addSoundBuffer(MemCategory c, const SoundBuffer& buf)
+{
+    int i = static_cast<int>(c);
+    audioBytes[i].fetch_add(soundSize(buf), memory_order_relaxed);
+    updatePeaks(i);
+}
+
+void MemoryTracker::removeSoundBuffer(MemCategory c, const SoundBuffer& buf)
+{
+    audioBytes[static_cast<int>(c)].fetch_sub(soundSize(buf), memory_order_relaxed);
+}
+
+MemCategory MemoryTracker::current() { return currentCategory; }
+void MemoryTracker::setCurrent(MemCategory c) { currentCategory = c; }
+
+size_t MemoryTracker::allocationCount() { return allocations.load(memory_order_relaxed); }
+size_t MemoryTracker::threadAllocationCount() { return threadAllocations; }
+
+void MemoryTracker::report(ostream& out)
+{
+    auto kb = [](size_t bytes) { return static_cast<double>(bytes) / 1024.0; };
+
+    out << fixed << setprecision(1);
+    out << left << setw(20) << "subsystem" << right
+        << setw(12) << "heap KB" << setw(12) << "heap peak" << setw(12) << "VRAM KB"
+        << setw(12) << "audio KB" << setw(12) << "total peak" << "\n";
+
+    size_t heap = 0, tex = 0, audio = 0;
+    for (int i = 0; i < COUNT; i++) {
+        heap += heapBytes[i]; tex += textureBytes[i]; audio += audioBytes[i];
+        out << left << setw(20) << names[i] << right
+            << setw(12) << kb(heapBytes[i]) << setw(12) << kb(heapPeak[i]) << setw(12) << kb(textureBytes[i])
+            << setw(12) << kb(audioBytes[i]) << setw(12) << kb(totalPeak[i]) << "\n";
+    }
+    out << left << setw(20) << "total" << right
+        << setw(12) << kb(heap) << setw(12) << "" << setw(12) << kb(tex) << setw(12) << kb(audio) << "\n";
+    out << "heap allocations so far: " << allocationCount() << "\n";
+}
+
+bool MemoryTracker::writeReport(const string& path)
+{
+    ofstream out(path);
+    if (!out) {
+        cerr << "Warning: can't write memory report " << path << "\n";
+        return false;
+    }
+    report(out);
+    return true;
+}
+
+void* operator new(size_t size)
+{
+    if (void* p = trackedAlloc(size)) return p;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* p = trackedAlloc(size)) return p;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return trackedAlloc(size); }
+
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { trackedFree(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { trackedFree(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { trackedFree(p); }
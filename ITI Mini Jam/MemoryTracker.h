@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+enum class MemCategory { General, Game, Menu, UI, SoundManager, RainSystem, ParallaxBackground, Count };
+
+// Per-subsystem memory accounting. Heap bytes come from the global
+// operator new/delete hooks in MemoryTracker.cpp and are charged to the
+// category of the innermost MemoryScope on the allocating thread. With
+// SFML linked as DLLs the hooks only see the exe's own allocations.
+// Texture (VRAM) and sound buffer bytes are registered by their owners.
+class MemoryTracker {
+public:
+    static void onAlloc(MemCategory c, size_t bytes);
+    static void onFree(MemCategory c, size_t bytes);
+
+    static void addTexture(MemCategory c, const sf::Texture& tex);
+    static void removeTexture(MemCategory c, const sf::Texture& tex);
+    static void addSoundBuffer(MemCategory c, const sf::SoundBuffer& buf);
+    static void removeSoundBuffer(MemCategory c, const sf::SoundBuffer& buf);
+
+    static MemCategory current();
+    static void setCurrent(MemCategory c);
+
+    // number of heap allocations made so far, all categories
+    static size_t allocationCount();
+    static size_t threadAllocationCount();
+
+    static void report(std::ostream& out);
+    static bool writeReport(const std::string& path);
+};
+
+// charges heap allocations on this thread to `c` until it goes out of scope
+class MemoryScope {
+public:
+    explicit MemoryScope(MemCategory c) : previous(MemoryTracker::current()) { MemoryTracker::setCurrent(c); }
+    ~MemoryScope() { MemoryTracker::setCurrent(previous); }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemCategory previous;
+};
+
+// debug builds assert that this thread makes no heap allocation while it
+// is alive; used around steady-state gameplay frames. It only sees the
+// exe's own allocations: with SFML linked as DLLs, what SFML allocates
+// inside its calls (say in PlayScene::draw) doesn't count, so a passing
+// frame isn't proof that nothing allocated.
+class NoAllocScope {
+public:
+#ifdef _DEBUG
+    explicit NoAllocScope(bool enabled = true) : enabled(enabled), start(MemoryTracker::threadAllocationCount()) {}
+    ~NoAllocScope() { assert((!enabled || MemoryTracker::threadAllocationCount() == start) && "heap allocation during a steady-state frame"); }
+private:
+    bool enabled;
+    size_t start;
+#else
+    explicit NoAllocScope(bool = true) {}
+#endif
+};
@@ -1,18 +1,28 @@
 #include "Menu.h"
 
-#include <iostream>
+#include "MemoryTracker.h"
 
 using namespace sf;
 using namespace std;
 
+vector<string> Menu::assets()
+{
+    return {
+        "Assets/MenusBackgrounds/MainMenu.png", "Assets/Title.png",
+        "Assets/Buttons/start.png", "Assets/Buttons/start_hover.png",
+        "Assets/Buttons/options.png", "Assets/Buttons/options_hover.png",
+        "Assets/Buttons/exit.png", "Assets/Buttons/exit_hover.png",
+    };
+}
+
 Menu::Menu(float WIDTH, float HEIGHT, SoundManager* sm)
 {
+    MemoryScope scope(MemCategory::Menu);
     soundMgr = sm;
-    if (!tMenuBg.loadFromFile("Assets/MenusBackgrounds/MainMenu.png"))
-        cerr << "Warning: MainMenu.png not found\n";
-    else {
-        bg.setTexture(tMenuBg);
-        bg.setScale(WIDTH / tMenuBg.getSize().x, HEIGHT / tMenuBg.getSize().y);
+    tMenuBg = &resources.texture("Assets/MenusBackgrounds/MainMenu.png");
+    if (tMenuBg->getSize().x) {
+        bg.setTexture(*tMenuBg);
+        bg.setScale(WIDTH / tMenuBg->getSize().x, HEIGHT / tMenuBg->getSize().y);
     }
 
     Vector2f btnSize(300, 80);
@@ -20,58 +30,43 @@ Menu::Menu(float WIDTH, float HEIGHT, SoundManager* sm)
     btnOptions = UIButton(btnSize, { (WIDTH / 2.f) + 350.f, (HEIGHT / 2.f) + 150.f });
     btnExit = UIButton(btnSize, { (WIDTH / 2.f) + 350.f, (HEIGHT / 2.f) + 300.f });
 
-    if (!tStart.loadFromFile("Assets/Buttons/start.png")) { /*fallback*/ }
-    else btnStart.rect.setTexture(&tStart);
-
-    if (!tStartHover.loadFromFile("Assets/Buttons/start_hover.png")) { /*fallback*/ }
+    tStart = &resources.texture("Assets/Buttons/start.png");
+    tStartHover = &resources.texture("Assets/Buttons/start_hover.png");
+    tOptions = &resources.texture("Assets/Buttons/options.png");
+    tOptionsHover = &resources.texture("Assets/Buttons/options_hover.png");
+    tExit = &resources.texture("Assets/Buttons/exit.png");
+    tExitHover = &resources.texture("Assets/Buttons/exit_hover.png");
 
-    if (!tOptions.loadFromFile("Assets/Buttons/options.png")) { /*fallback*/ }
-    else btnOptions.rect.setTexture(&tOptions);
-
-    if (!tOptionsHover.loadFromFile("Assets/Buttons/options_hover.png")) { /*fallback*/ }
-
-    if (!tExit.loadFromFile("Assets/Buttons/exit.png")) { /*fallback*/ }
-    else btnExit.rect.setTexture(&tExit);
-
-    if (!tExitHover.loadFromFile("Assets/Buttons/exit_hover.png")) { /*fallback*/ }
+    btnStart.setTextures(tStart, tStartHover);
+    btnOptions.setTextures(tOptions, tOptionsHover);
+    btnExit.setTextures(tExit, tExitHover);
 
     // Load the title texture and set its position
-    if (!tTitle.loadFromFile("Assets/Title.png")) {
-        cerr << "Warning: Title.png not found\n";
-    }
-    else {
-        sTitle.setTexture(tTitle);
+    tTitle = &resources.texture("Assets/Title.png");
+    if (tTitle->getSize().x) {
+        sTitle.setTexture(*tTitle);
         float scaleFactor = 0.4f;
         sTitle.setScale(scaleFactor, scaleFactor);
 
-        float scaledW = tTitle.getSize().x * scaleFactor;
-        float scaledH = tTitle.getSize().y * scaleFactor;
+        float scaledW = tTitle->getSize().x * scaleFactor;
+        float scaledH = tTitle->getSize().y * scaleFactor;
 
         sTitle.setPosition(
             WIDTH / 2.f - scaledW / 2.f + 350.f,
             btnStart.rect.getPosition().y - scaledH - 120.f
         );
     }
+
+    layer.create(static_cast<unsigned>(WIDTH), static_cast<unsigned>(HEIGHT));
 }
 
 int Menu::update(RenderWindow& window)
 {
     Vector2i mousePos = Mouse::getPosition(window);
 
-    if (btnStart.contains(mousePos)) {
-        if (tStartHover.getSize().x) btnStart.rect.setTexture(&tStartHover);
-    }
-    else if (tStart.getSize().x) btnStart.rect.setTexture(&tStart);
-
-    if (btnOptions.contains(mousePos)) {
-        if (tOptionsHover.getSize().x) btnOptions.rect.setTexture(&tOptionsHover);
-    }
-    else if (tOptions.getSize().x) btnOptions.rect.setTexture(&tOptions);
-
-    if (btnExit.contains(mousePos)) {
-        if (tExitHover.getSize().x) btnExit.rect.setTexture(&tExitHover);
-    }
-    else if (tExit.getSize().x) btnExit.rect.setTexture(&tExit);
+    btnStart.setHovered(btnStart.contains(mousePos));
+    btnOptions.setHovered(btnOptions.contains(mousePos));
+    btnExit.setHovered(btnExit.contains(mousePos));
 
     if (Mouse::isButtonPressed(Mouse::Left)) {
         if (btnStart.contains(mousePos)) {
@@ -91,14 +86,18 @@ int Menu::update(RenderWindow& window)
     return 0;
 }
 
-void Menu::draw(RenderWindow& window)
+void Menu::draw(DrawTarget& target)
 {
-    if (tMenuBg.getSize().x) window.draw(bg);
-    btnStart.draw(window);
-    btnOptions.draw(window);
-    btnExit.draw(window);
-    // Draw the title sprite
-    if (tTitle.getSize().x) window.draw(sTitle);
+    DrawScope scope(DrawCategory::Menu);
+    // hover changes are the only thing that redraws the menu
+    layer.track(btnStart.dirty);
+    layer.track(btnOptions.dirty);
+    layer.track(btnExit.dirty);
+    layer.draw(target, [this](DrawTarget& cached, const RenderStates& states) {
+        if (tMenuBg->getSize().x) cached.draw(bg, states);
+        if (tTitle->getSize().x) cached.draw(sTitle, states);
+        btnStart.draw(cached, states);
+        btnOptions.draw(cached, states);
+        btnExit.draw(cached, states);
+    });
 }
-
-
@@ -1,24 +1,32 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
 
+#include "ResourceCache.h"
 #include "SoundManager.h"
 #include "UI.h"
 
 class Menu {
 public:
+    ResourceSet resources{ MemCategory::Menu };
     sf::Sprite bg;
-    sf::Texture tMenuBg;
+    const sf::Texture* tMenuBg;
     UIButton btnStart, btnOptions, btnExit;
-    sf::Texture tStart, tStartHover, tOptions, tOptionsHover, tExit, tExitHover;
-    sf::Texture tTitle;
+    const sf::Texture *tStart, *tStartHover, *tOptions, *tOptionsHover, *tExit, *tExitHover;
+    const sf::Texture* tTitle;
 	sf::Sprite sTitle;
+    CachedLayer layer;      // background, title and buttons
     SoundManager* soundMgr = nullptr;
 
     Menu(float WIDTH, float HEIGHT, SoundManager* sm = nullptr);
 
+    // what the constructor loads, for prefetching
+    static std::vector<std::string> assets();
+
     int update(sf::RenderWindow& window);
-    void draw(sf::RenderWindow& window);
+    void draw(DrawTarget& target);
 };
 
 
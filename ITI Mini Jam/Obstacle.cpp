@@ -4,15 +4,31 @@ using namespace sf;
 
 Obstacle::Obstacle(float x, float y, float width, float height, Color color)
 {
+    place(x, y, width, height, color);
+}
+
+void Obstacle::place(float x, float y, float width, float height, Color color)
+{
+    body.setTexture(nullptr);
+    mask = nullptr;
+    maskLevel = 0;
     body.setSize({ width, height });
     body.setOrigin(width / 2.f, height / 2.f);
     body.setPosition(x, y);
     body.setFillColor(color);
 }
 
-void Obstacle::draw(RenderWindow& window)
+void Obstacle::setArt(const Texture& texture, const CollisionMask* artMask)
 {
-    window.draw(body);
+    body.setTexture(&texture, true);
+    body.setFillColor(Color::White);
+    mask = artMask && !artMask->empty() ? artMask : nullptr;
+    if (mask) maskLevel = mask->levelFor(body.getSize().x, body.getSize().y);
+}
+
+void Obstacle::draw(DrawTarget& target, const RenderStates& states)
+{
+    target.draw(body, states);
 }
 
 FloatRect Obstacle::getBounds() const
@@ -20,4 +36,9 @@ FloatRect Obstacle::getBounds() const
     return body.getGlobalBounds();
 }
 
+bool Obstacle::hits(const FloatRect& box, const FloatRect& bounds) const
+{
+    return !mask || mask->overlaps(box, bounds, maskLevel);
+}
+
 
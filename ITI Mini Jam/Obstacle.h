@@ -1,16 +1,28 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "CollisionMask.h"
+#include "RenderStats.h"
 
 class Obstacle
 {
 public:
     sf::RectangleShape body;
+    // without a mask the whole rectangle is deadly
+    const CollisionMask* mask = nullptr;
+    int maskLevel = 0;
 
     Obstacle(float x = 0.f, float y = 0.f, float width = 80.f, float height = 120.f, sf::Color color = sf::Color(180, 40, 40, 220));
+    // back to a plain rectangle at a new place, for level rebuilds
+    void place(float x, float y, float width, float height, sf::Color color = sf::Color(180, 40, 40, 220));
 
-    void draw(sf::RenderWindow& window);
+    // stretches the art over the rectangle, hits follow its opaque pixels
+    void setArt(const sf::Texture& texture, const CollisionMask* artMask);
+
+    void draw(DrawTarget& target, const sf::RenderStates& states = sf::RenderStates::Default);
     sf::FloatRect getBounds() const;
+    // `box` and `bounds` (this obstacle's, in the same frame) already overlap
+    bool hits(const sf::FloatRect& box, const sf::FloatRect& bounds) const;
 };
 
 
@@ -1,13 +1,18 @@
 #include "OptionsMenu.h"
 
-#include <iostream>
-#include <string>
+#include "MemoryTracker.h"
 
 using namespace sf;
 using namespace std;
 
+vector<string> OptionsMenu::assets()
+{
+    return { "Assets/Fonts/MyFont.ttf", "Assets/MenusBackgrounds/MainMenu.png" };
+}
+
 OptionsMenu::OptionsMenu(float WIDTH, float HEIGHT, SoundManager* sm)
 {
+    MemoryScope scope(MemCategory::UI);
     soundMgr = sm;
     soundMgr->setMusicVolume(10.f);
 	soundMgr->setSFXVolume(30.f);
@@ -21,25 +26,35 @@ OptionsMenu::OptionsMenu(float WIDTH, float HEIGHT, SoundManager* sm)
    
     backButton = UIButton({ 200.f, 70.f }, { centerX, baseY + 300.f }, Color(150, 150, 150));
 
-    font = Font();
-    if (!font.loadFromFile("Assets/Fonts/MyFont.ttf"))
-        cerr << "Warning: arial.ttf not found (using default font)\n";
+    // same background as the main menu, it is shared through the cache
+    font = &resources.font("Assets/Fonts/MyFont.ttf");
+    const Texture& menuBg = resources.texture("Assets/MenusBackgrounds/MainMenu.png");
+    if (menuBg.getSize().x) setBackground(menuBg);
 
-    titleText.setFont(font);
+    titleText.setFont(*font);
     titleText.setCharacterSize(36);
     titleText.setString("Options");
     titleText.setPosition(centerX - 60.f, baseY - 80.f);
     titleText.setFillColor(Color::White);
 
-    musicLabel.setFont(font); musicLabel.setCharacterSize(20); musicLabel.setString("Music Volume"); musicLabel.setPosition(centerX - 200.f, baseY - 10.f); musicLabel.setFillColor(Color::White);
-    sfxLabel.setFont(font); sfxLabel.setCharacterSize(20); sfxLabel.setString("SFX Volume"); sfxLabel.setPosition(centerX - 200.f, baseY + 120.f); sfxLabel.setFillColor(Color::White);
+    musicLabel.setFont(*font); musicLabel.setCharacterSize(20); musicLabel.setString("Music Volume"); musicLabel.setPosition(centerX - 200.f, baseY - 10.f); musicLabel.setFillColor(Color::White);
+    sfxLabel.setFont(*font); sfxLabel.setCharacterSize(20); sfxLabel.setString("SFX Volume"); sfxLabel.setPosition(centerX - 200.f, baseY + 120.f); sfxLabel.setFillColor(Color::White);
 
-    musicValueText.setFont(font); musicValueText.setCharacterSize(18); musicValueText.setPosition(centerX + 220.f, baseY + 10.f); musicValueText.setFillColor(Color::White);
-    sfxValueText.setFont(font); sfxValueText.setCharacterSize(18); sfxValueText.setPosition(centerX + 220.f, baseY + 130.f); sfxValueText.setFillColor(Color::White);
+    musicValue.text.setFont(*font); musicValue.text.setCharacterSize(18); musicValue.text.setPosition(centerX + 220.f, baseY + 10.f); musicValue.text.setFillColor(Color::White);
+    sfxValue.text.setFont(*font); sfxValue.text.setCharacterSize(18); sfxValue.text.setPosition(centerX + 220.f, baseY + 130.f); sfxValue.text.setFillColor(Color::White);
+
+    background.setSize({ WIDTH, HEIGHT });
+    layer.create(static_cast<unsigned>(WIDTH), static_cast<unsigned>(HEIGHT));
 
     updateValueTexts();
 }
 
+void OptionsMenu::setBackground(const Texture& tex)
+{
+    background.setTexture(&tex, true);
+    layer.invalidate();
+}
+
 int OptionsMenu::update(RenderWindow& window, const Event& ev)
 {
     bool changed = false;
@@ -66,19 +81,27 @@ int OptionsMenu::update(RenderWindow& window, const Event& ev)
 }
 
 void OptionsMenu::updateValueTexts() {
-    musicValueText.setString(to_string(musicSlider.getValue()) + "%");
-    sfxValueText.setString(to_string(sfxSlider.getValue()) + "%");
+    musicValue.setValue(musicSlider.getValue(), "%");
+    sfxValue.setValue(sfxSlider.getValue(), "%");
 }
 
-void OptionsMenu::draw(RenderWindow& window) {
-    window.draw(titleText);
-    window.draw(musicLabel);
-    window.draw(sfxLabel);
-    musicSlider.draw(window);
-    sfxSlider.draw(window);
-    window.draw(musicValueText);
-    window.draw(sfxValueText);
-    backButton.draw(window);
+void OptionsMenu::draw(DrawTarget& target) {
+    DrawScope scope(DrawCategory::UI);
+    // redrawn while a slider moves, a single sprite otherwise
+    layer.track(musicSlider.dirty);
+    layer.track(sfxSlider.dirty);
+    layer.track(musicValue.dirty);
+    layer.track(sfxValue.dirty);
+    layer.track(backButton.dirty);
+    layer.draw(target, [this](DrawTarget& cached, const RenderStates& states) {
+        if (background.getTexture()) cached.draw(background, states);
+        cached.draw(titleText, states);
+        cached.draw(musicLabel, states);
+        cached.draw(sfxLabel, states);
+        musicSlider.draw(cached, states);
+        sfxSlider.draw(cached, states);
+        musicValue.draw(cached, states);
+        sfxValue.draw(cached, states);
+        backButton.draw(cached, states);
+    });
 }
-
-
@@ -1,28 +1,37 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
 
+#include "ResourceCache.h"
 #include "SoundManager.h"
 #include "UI.h"
 
 class OptionsMenu {
 public:
+    ResourceSet resources{ MemCategory::UI };
     Slider musicSlider;
     Slider sfxSlider;
     UIButton backButton;
-    sf::Font font;
+    const sf::Font* font;
     sf::Text titleText;
     sf::Text musicLabel;
     sf::Text sfxLabel;
-    sf::Text musicValueText;
-    sf::Text sfxValueText;
+    UILabel musicValue;
+    UILabel sfxValue;
+    sf::RectangleShape background;
+    CachedLayer layer;      // the whole screen
 
     SoundManager* soundMgr = nullptr;
 
     OptionsMenu(float WIDTH, float HEIGHT, SoundManager* sm = nullptr);
 
+    static std::vector<std::string> assets();
+
+    void setBackground(const sf::Texture& tex);
     int update(sf::RenderWindow& window, const sf::Event& ev);
-    void draw(sf::RenderWindow& window);
+    void draw(DrawTarget& target);
 
 private:
     void updateValueTexts();
@@ -1,5 +1,9 @@
 #include "ParallaxBackground.h"
 
+#include "AssetPack.h"
+#include "MemoryTracker.h"
+
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -7,8 +11,9 @@ using namespace sf;
 using namespace std;
 
 ParallaxBackground::ParallaxBackground(int count, float W, float H, const vector<float>& speedList, int start)
-	: layerCount(count), WIDTH(W), HEIGHT(H), speeds(speedList), startLayer(start)
+	: layerCount(count), WIDTH(W), HEIGHT(H), speeds(speedList), startLayer(start), visibleLayers(count)
 {
+    MemoryScope scope(MemCategory::ParallaxBackground);
     textures.resize(layerCount);
     layers.resize(layerCount);
     offsets.resize(layerCount, 0.f);
@@ -18,34 +23,73 @@ ParallaxBackground::ParallaxBackground(int count, float W, float H, const vector
 		int name = start + i;
         string filename = "Assets/Backgrounds/BG_0" + to_string(name) + ".png";
 
-        if (!textures[i].loadFromFile(filename))
+        if (!AssetPack::loadTexture(textures[i], filename))
             cerr << "Warning: Can't load " << filename << " (placeholder will be used)\n";
 
+        MemoryTracker::addTexture(MemCategory::ParallaxBackground, textures[i]);
+
         textures[i].setRepeated(true);
         textures[i].setSmooth(true);
 
         texHeight = textures[i].getSize().y ? static_cast<float>(textures[i].getSize().y) : HEIGHT;
 
-        layers[i].setSize({ WIDTH, HEIGHT });
+        // one texel wider than the screen, the layer is placed at texel boundaries
+        layers[i].setSize({ static_cast<float>(static_cast<int>(WIDTH) + 1), HEIGHT });
         layers[i].setTexture(&textures[i]);
-        layers[i].setTextureRect(IntRect(0, 0, static_cast<int>(WIDTH), static_cast<int>(texHeight)));
+        layers[i].setTextureRect(IntRect(0, 0, static_cast<int>(WIDTH) + 1, static_cast<int>(texHeight)));
     }
 }
 
+ParallaxBackground::~ParallaxBackground()
+{
+    for (auto& t : textures)
+        MemoryTracker::removeTexture(MemCategory::ParallaxBackground, t);
+}
+
 void ParallaxBackground::update(float dt, float direction, int startLayer, int endLayer)
 {
     for (int i = startLayer; i < endLayer; i++)
     {
         offsets[i] += speeds[i] * dt * direction;
-        if (offsets[i] > 1000000.f || offsets[i] < -1000000.f) offsets[i] = fmod(offsets[i], 1000000.f);
-        layers[i].setTextureRect(IntRect(static_cast<int>(offsets[i]), 0, static_cast<int>(WIDTH), static_cast<int>(texHeight)));
+        // the texture repeats, so a whole period is invisible
+        float period = static_cast<float>(textures[i].getSize().x);
+        if (period > 0.f) offsets[i] = fmod(offsets[i], period);
+    }
+}
+
+void ParallaxBackground::applyOffsets(const float* values, float viewLeft, double originX)
+{
+    for (int i = 0; i < layerCount; i++)
+    {
+        double texel = values[i] + originX + viewLeft;
+        double whole = floor(texel);
+        double period = textures[i].getSize().x;
+        int left = static_cast<int>(period > 0.0 ? fmod(whole, period) : whole);
+
+        layers[i].setPosition(viewLeft - static_cast<float>(texel - whole), 0.f);
+        layers[i].setTextureRect(IntRect(left, 0, static_cast<int>(WIDTH) + 1, static_cast<int>(texHeight)));
     }
 }
 
-void ParallaxBackground::draw(RenderWindow& window)
+void ParallaxBackground::setVisibleLayers(int count)
+{
+    visibleLayers = max(1, min(count, layerCount));
+}
+
+void ParallaxBackground::setSmooth(bool smooth)
+{
+    for (auto& t : textures)
+        t.setSmooth(smooth);
+}
+
+void ParallaxBackground::draw(DrawTarget& target)
 {
-    for (auto& layer : layers)
-        window.draw(layer);
+    DrawScope scope(DrawCategory::Parallax);
+    // dropped layers come from the middle distance, the sky and the
+    // nearest layers carry most of the picture
+    target.draw(layers[0]);
+    for (int i = layerCount - (visibleLayers - 1); i < layerCount; i++)
+        if (i > 0) target.draw(layers[i]);
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "RenderStats.h"
 #include <vector>
 
 class ParallaxBackground
@@ -12,14 +13,24 @@ public:
     std::vector<float> speeds;
     std::vector<float> offsets;
     int startLayer = 0;
+    int visibleLayers;  // farthest layer plus the nearest (visibleLayers - 1)
 
     float WIDTH, HEIGHT, texHeight;
 
     ParallaxBackground(int count, float W, float H, const std::vector<float>& speedList, int start);
+    ~ParallaxBackground();
 
+    // simulation side, only moves the offsets (wrapped to the texture width)
     void update(float dt, float direction, int startLayer, int endLayer);
+    // render side: the layers are screen sized and follow the view, the
+    // texture is placed so level x shows texel values[i] + x (one value per
+    // layer); viewLeft is in simulation coordinates, originX is its level x
+    void applyOffsets(const float* values, float viewLeft, double originX);
 
-    void draw(sf::RenderWindow& window);
+    void setVisibleLayers(int count);
+    void setSmooth(bool smooth);
+
+    void draw(DrawTarget& target);
 };
 
 
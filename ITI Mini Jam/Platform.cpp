@@ -3,15 +3,20 @@
 using namespace sf;
 
 Platform::Platform(float x, float y, float width, float height, Color color)
+{
+    place(x, y, width, height, color);
+}
+
+void Platform::place(float x, float y, float width, float height, Color color)
 {
     body.setSize({ width, height });
     body.setPosition(x, y);
     body.setFillColor(color);
 }
 
-void Platform::draw(RenderWindow& window)
+void Platform::draw(DrawTarget& target, const RenderStates& states)
 {
-    window.draw(body);
+    target.draw(body, states);
 }
 
 FloatRect Platform::getBounds() const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "RenderStats.h"
 
 class Platform
 {
@@ -8,8 +9,10 @@ public:
     sf::RectangleShape body;
 
     Platform(float x = 0.f, float y = 0.f, float width = 100.f, float height = 20.f, sf::Color color = sf::Color::White);
+    // moves and resizes the existing shape, for level rebuilds
+    void place(float x, float y, float width, float height, sf::Color color);
 
-    void draw(sf::RenderWindow& window);
+    void draw(DrawTarget& target, const sf::RenderStates& states = sf::RenderStates::Default);
 
     sf::FloatRect getBounds() const;
 };
@@ -1,5 +1,9 @@
 #include "Player.h"
 
+#include "AnimationSystem.h"
+#include "AssetPack.h"
+#include "InputBuffer.h"
+#include "MemoryTracker.h"
 #include "SoundManager.h"
 
 #include <iostream>
@@ -11,112 +15,93 @@ Player::Player(SoundManager* manager)
 {
     soundMgr = manager;
 
-    if (!tIdle.loadFromFile("Assets/Character/idle.png"))
+    if (!AssetPack::loadTexture(tIdle, "Assets/Character/idle.png"))
         cerr << "Warning: idle.png not found (player texture placeholder)\n";
-    if (!tRun.loadFromFile("Assets/Character/run.png"))
+    if (!AssetPack::loadTexture(tRun, "Assets/Character/run.png"))
         cerr << "Warning: run.png not found (player texture placeholder)\n";
-    if (!tJump.loadFromFile("Assets/Character/jump.png"))
+    if (!AssetPack::loadTexture(tJump, "Assets/Character/jump.png"))
         cerr << "Warning: jump.png not found (player texture placeholder)\n";
 
+    MemoryTracker::addTexture(MemCategory::Game, tIdle);
+    MemoryTracker::addTexture(MemCategory::Game, tRun);
+    MemoryTracker::addTexture(MemCategory::Game, tJump);
+
     sprite.setTexture(tIdle);
     sprite.setTextureRect(IntRect(0, 0, frameW, frameH));
     sprite.setScale(spriteScale, spriteScale);
     sprite.setOrigin(frameW / 2.f, frameH / 2.f);
-
-    hitbox.setSize({ 40.f, 150.f });
-    hitbox.setOrigin(20.f, 40.f);
-    hitbox.setPosition(300.f, 300.f);
-    hitbox.setFillColor(Color::Transparent);
-
-    maxFrames = framesIdle;
+    view = sprite;
 }
 
-void Player::updateMovement()
+Player::~Player()
 {
-    bool moving = false;
-    movingHorizontal = false;
-
-    if (Keyboard::isKeyPressed(Keyboard::A) || Keyboard::isKeyPressed(Keyboard::Left))
-    {
-        hitbox.move(-speed, 0);
-        facingRight = false;
-        moving = true;
-        movingHorizontal = true;
-    }
+    MemoryTracker::removeTexture(MemCategory::Game, tIdle);
+    MemoryTracker::removeTexture(MemCategory::Game, tRun);
+    MemoryTracker::removeTexture(MemCategory::Game, tJump);
+}
 
-    if (Keyboard::isKeyPressed(Keyboard::D) || Keyboard::isKeyPressed(Keyboard::Right))
-    {
-        hitbox.move(speed, 0);
-        facingRight = true;
-        moving = true;
-        movingHorizontal = true;
-    }
+void Player::attachAnimation(AnimationSystem& system)
+{
+    // one clip per State, indexed by the enum
+    const Texture* sheets[] = { &tIdle, &tRun, &tJump };
+    const int frameCounts[] = { framesIdle, framesRun, framesJump };
+    const float frameTimes[] = { 0.19f, 0.09f, 0.2f };
 
-    if ((Keyboard::isKeyPressed(Keyboard::Space) || Keyboard::isKeyPressed(Keyboard::W) || Keyboard::isKeyPressed(Keyboard::Up)) && onGround)
-    {
-        velY = -16.f;
-        onGround = false;
-    }
+    for (int s = 0; s < 3; s++)
+        stateClips[s] = system.addClip(*sheets[s], frameW, frameH, frameCounts[s], frameTimes[s]);
 
-    velY += gravity;
-    hitbox.move(0, velY);
-
-    int newState = currentState;
-    if (!onGround)
-        newState = JUMP;
-    else if (moving)
-        newState = RUN;
-    else
-        newState = IDLE;
-
-    if (newState != currentState)
-    {
-        currentState = newState;
-        currentFrame = 0;
-
-        if (currentState == IDLE) { sprite.setTexture(tIdle); maxFrames = framesIdle; }
-        if (currentState == RUN) { sprite.setTexture(tRun); maxFrames = framesRun; }
-        if (currentState == JUMP) { sprite.setTexture(tJump); maxFrames = framesJump; }
-    }
+    anim = &system;
+    animEntity = system.add(sprite, stateClips[body.state]);
 }
 
-void Player::updateAnimation()
+void Player::updateMovement(InputBuffer& input, float dt)
 {
-    timeSince += animClock.restart().asSeconds();
+    PlayerIntent intent;
+    intent.left = input.isHeld(Action::Left) || input.wasPressed(Action::Left);
+    intent.right = input.isHeld(Action::Right) || input.wasPressed(Action::Right);
+    intent.jump = input.jumpBuffered(tuning.jumpBufferTime);
 
-    if (currentState == IDLE) animSpeed = 0.19f;
-    else if (currentState == RUN) animSpeed = 0.09f;
-    else animSpeed = 0.2f; 
+    int previousState = body.state;
+    if (stepPlayer(body, intent, tuning, dt))
+        input.consumeJump(tuning.jumpBufferTime);
+
+    if (body.state != previousState && anim)
+        anim->play(animEntity, stateClips[body.state]);
+}
 
-    if (timeSince >= animSpeed)
-    {
-        timeSince = 0;
-        currentFrame++;
-        if (currentFrame >= maxFrames) currentFrame = 0;
+// frames are advanced by the AnimationSystem, this only keeps the
+// transform in sync and skips it when nothing changed
+void Player::updateAnimation()
+{
+    if (body.facingRight != spriteFacingRight) {
+        sprite.setScale(body.facingRight ? spriteScale : -spriteScale, spriteScale);
+        spriteFacingRight = body.facingRight;
     }
 
-    sprite.setTextureRect(IntRect(currentFrame * frameW, 0, frameW, frameH));
-    sprite.setScale(facingRight ? spriteScale : -spriteScale, spriteScale);
-    sprite.setPosition(hitbox.getPosition());
+    Vector2f pos(body.x, body.y);
+    if (pos != spritePos) {
+        sprite.setPosition(pos);
+        spritePos = pos;
+    }
 }
 
-void Player::draw(RenderWindow& window)
+void Player::draw(DrawTarget& target)
 {
-    window.draw(sprite);
+    target.draw(view);
 }
 
-FloatRect Player::getGlobalBounds() const { return hitbox.getGlobalBounds(); }
-Vector2f Player::getPosition() const { return hitbox.getPosition(); }
-void Player::move(float dx, float dy) { hitbox.move(dx, dy); }
-void Player::setPosition(float x, float y) { hitbox.setPosition(x, y); sprite.setPosition(x, y); }
+FloatRect Player::getGlobalBounds() const { return body.bounds(tuning); }
+Vector2f Player::getPosition() const { return Vector2f(body.x, body.y); }
+void Player::move(float dx, float dy) { body.x += dx; body.y += dy; }
+void Player::setPosition(float x, float y) { body.x = x; body.y = y; }
 
 bool Player::isRunningOnGround() const
 {
-    return movingHorizontal && onGround;
+    return body.movingHorizontal && body.onGround;
 }
 
 bool Player::isMovingHorizontally() const
 {
-    return movingHorizontal;
+    return body.movingHorizontal;
 }
 
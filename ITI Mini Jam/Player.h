@@ -1,33 +1,38 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "PlayerPhysics.h"
+#include "RenderStats.h"
 
+class AnimationSystem;
+class InputBuffer;
 class SoundManager;
 
 class Player
 {
 public:
     sf::Texture tIdle, tRun, tJump;
-    sf::Sprite sprite;
-    sf::RectangleShape hitbox;
+    sf::Sprite sprite;      // simulation side, animated by the AnimationSystem
+    sf::Sprite view;        // render side, set from snapshots
+    PlayerBody body;        // position, velocity, state: see PlayerPhysics
+    PlayerTuning tuning;
     int frameW = 1024, frameH = 1024;
     int framesIdle = 3, framesRun = 6, framesJump = 7;
-    int currentState = 0;
-    enum State { IDLE, RUN, JUMP };
-    float timeSince = 0.f, animSpeed = 0.09f;
-    int currentFrame = 0, maxFrames = 6;
-    bool facingRight = true, onGround = false;
-    bool movingHorizontal = false;
-    float speed = 5.f, gravity = 0.6f, velY = 0.f;
-    sf::Clock animClock;
     float spriteScale = 0.2f;
+    AnimationSystem* anim = nullptr;
+    int animEntity = -1;
+    int stateClips[3] = { -1, -1, -1 };
+    bool spriteFacingRight = true;    // what the sprite transform currently shows
+    sf::Vector2f spritePos;
     SoundManager* soundMgr = nullptr;
 
     Player(SoundManager* manager = nullptr);
+    ~Player();
 
-    void updateMovement();
+    void attachAnimation(AnimationSystem& system);
+    void updateMovement(InputBuffer& input, float dt);
     void updateAnimation();
-    void draw(sf::RenderWindow& window);
+    void draw(DrawTarget& target);
 
     sf::FloatRect getGlobalBounds() const;
     sf::Vector2f getPosition() const;
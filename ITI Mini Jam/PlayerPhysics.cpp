@@ -0,0 +1,85 @@
+#include "PlayerPhysics.h"
+
+#include <algorithm>
+
+using namespace sf;
+using namespace std;
+
+bool stepPlayer(PlayerBody& body, const PlayerIntent& intent, const PlayerTuning& tuning, float dt)
+{
+    bool moving = false;
+    body.movingHorizontal = false;
+
+    if (intent.left)
+    {
+        body.x -= tuning.speed;
+        body.facingRight = false;
+        moving = true;
+        body.movingHorizontal = true;
+    }
+
+    if (intent.right)
+    {
+        body.x += tuning.speed;
+        body.facingRight = true;
+        moving = true;
+        body.movingHorizontal = true;
+    }
+
+    // coyote time: onGround is from last tick's collision pass
+    if (body.onGround) body.groundTimer = tuning.coyoteTime;
+    else body.groundTimer -= dt;
+
+    bool jumped = false;
+    if (body.groundTimer > 0.f && intent.jump)
+    {
+        body.velY = -tuning.jumpSpeed;
+        body.onGround = false;
+        body.groundTimer = 0.f;
+        jumped = true;
+    }
+
+    body.velY += tuning.gravity;
+    body.y += body.velY;
+
+    if (!body.onGround)
+        body.state = PlayerBody::JUMP;
+    else if (moving)
+        body.state = PlayerBody::RUN;
+    else
+        body.state = PlayerBody::IDLE;
+
+    return jumped;
+}
+
+void resolveCollision(PlayerBody& body, const PlayerTuning& tuning, const FloatRect& solid)
+{
+    FloatRect hb = body.bounds(tuning);
+    if (!hb.intersects(solid)) return;
+
+    float overlapLeft = hb.left + hb.width - solid.left;
+    float overlapRight = solid.left + solid.width - hb.left;
+    float overlapTop = hb.top + hb.height - solid.top;
+    float overlapBottom = solid.top + solid.height - hb.top;
+
+    float minOverlapX = min(overlapLeft, overlapRight);
+    float minOverlapY = min(overlapTop, overlapBottom);
+
+    if (minOverlapX < minOverlapY) {
+        if (overlapLeft < overlapRight)
+            body.x -= overlapLeft;
+        else
+            body.x += overlapRight;
+    }
+    else {
+        if (overlapTop < overlapBottom) {
+            body.y -= overlapTop;
+            body.velY = 0;
+            body.onGround = true;
+        }
+        else {
+            body.y += overlapBottom;
+            body.velY = 0;
+        }
+    }
+}
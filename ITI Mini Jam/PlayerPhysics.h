@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// Player movement as plain data and free functions, shared by Player in
+// the game and by the headless Playtester. No SFML objects, so it runs
+// on any thread.
+
+struct PlayerTuning {
+    float speed = 5.f;              // per tick
+    float gravity = 0.6f;           // per tick
+    float jumpSpeed = 16.f;
+    float coyoteTime = 0.1f;        // can still jump this long after walking off a ledge
+    float jumpBufferTime = 0.12f;   // a jump pressed this long before landing still fires
+    float width = 40.f, height = 150.f;
+    float originX = 20.f, originY = 40.f;   // position of (x, y) inside the box
+};
+
+struct PlayerIntent {
+    bool left, right;
+    bool jump;      // a jump press is buffered
+};
+
+struct PlayerBody {
+    enum State { IDLE, RUN, JUMP };
+
+    float x = 300.f, y = 300.f;
+    float velY = 0.f;
+    float groundTimer = 0.f;
+    int state = IDLE;
+    bool onGround = false, facingRight = true, movingHorizontal = false;
+
+    sf::FloatRect bounds(const PlayerTuning& t) const { return sf::FloatRect(x - t.originX, y - t.originY, t.width, t.height); }
+};
+
+// one tick of input, coyote time, jump and gravity; returns true if the
+// buffered jump was used
+bool stepPlayer(PlayerBody& body, const PlayerIntent& intent, const PlayerTuning& tuning, float dt);
+
+// pushes the body out of `solid` along the smaller overlap; landing on
+// top grounds it
+void resolveCollision(PlayerBody& body, const PlayerTuning& tuning, const sf::FloatRect& solid);
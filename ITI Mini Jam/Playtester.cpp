@@ -0,0 +1,143 @@
+#include "Playtester.h"
+
+#include "AabbSet.h"
+#include "LevelGenerator.h"
+#include "PlayerPhysics.h"
+#include "WorldState.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    const float TICK = 1.f / 60.f;
+
+    // closest edge of a solid in front of the bot that it has to clear
+    float distanceAhead(const LevelLayout& level, const FloatRect& hb)
+    {
+        float feet = hb.top + hb.height;
+        float right = hb.left + hb.width;
+        float best = 1e9f;
+        for (int i = 0; i < level.obstacleCount; i++) {
+            const FloatRect& o = level.obstacles[i];
+            if (o.left + o.width > hb.left) best = min(best, o.left - right);
+        }
+        for (int i = 0; i < level.platformCount; i++) {
+            const FloatRect& p = level.platforms[i];
+            if (p.top < feet - 1.f && p.left + p.width > hb.left) best = min(best, p.left - right);
+        }
+        return best;
+    }
+}
+
+Playtester::Result Playtester::playOne(uint32_t seed)
+{
+    // the layout is a few KB of rects, kept per thread so runs don't allocate
+    thread_local LevelLayout level;
+    thread_local AabbSet hazards;
+    LevelGenerator::generate(seed, LevelGenerator::HEADLESS_WIDTH, LevelGenerator::HEADLESS_HEIGHT, level);
+    hazards.clear();
+    for (int i = 0; i < level.obstacleCount; i++)
+        hazards.add(level.obstacles[i]);
+
+    // per-run reaction: how early the bot jumps, and some sloppiness
+    Rng rng = Rng::seeded(seed * 2654435761u + 1);
+    const float reach = 40.f + rng.uniform() * 120.f;
+    const float sloppiness = rng.uniform() * 0.1f;
+
+    PlayerTuning tuning;
+    PlayerBody body;
+    const float startX = body.x;
+    float bestX = body.x;
+    int stuckTicks = 0;
+    float jumpPressedAt = -1.f;
+
+    Result r = { 0.f, 0, -1 };
+    for (int tick = 0; tick < MAX_TICKS; tick++)
+    {
+        float now = tick * TICK;
+        FloatRect hb = body.bounds(tuning);
+
+        float ahead = distanceAhead(level, hb);
+        if ((ahead >= 0.f && ahead < reach && rng.uniform() >= sloppiness) || stuckTicks > 20)
+            jumpPressedAt = now;
+
+        PlayerIntent intent;
+        intent.left = false;
+        intent.right = true;
+        intent.jump = jumpPressedAt >= 0.f && now - jumpPressedAt <= tuning.jumpBufferTime;
+        if (stepPlayer(body, intent, tuning, TICK))
+            jumpPressedAt = -1.f;
+
+        body.onGround = false;
+        resolveCollision(body, tuning, level.ground);
+        for (int i = 0; i < level.platformCount; i++)
+            resolveCollision(body, tuning, level.platforms[i]);
+
+        r.ticks = tick + 1;
+        r.obstacle = hazards.first(body.bounds(tuning));
+        if (r.obstacle >= 0 || body.x >= level.endX) break;
+
+        if (body.x > bestX + 0.5f) { bestX = body.x; stuckTicks = 0; }
+        else stuckTicks++;
+    }
+    r.distance = body.x - startX;
+    return r;
+}
+
+bool Playtester::run(int runs, uint32_t seed, unsigned threads)
+{
+    if (runs <= 0) return false;
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min(threads, static_cast<unsigned>(runs));
+
+    // one slot per run, written by whichever worker claims it
+    vector<Result> results(runs);
+    atomic<int> nextRun{ 0 };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            for (int i = nextRun++; i < runs; i = nextRun++)
+                results[i] = playOne(seed + static_cast<uint32_t>(i));
+        });
+    }
+    for (auto& w : workers) w.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long long totalTicks = 0;
+    int survived = 0;
+    double sum = 0.0;
+    vector<float> distances(runs);
+    vector<int> deathsAt(LevelLayout::MAX_OBSTACLES, 0);
+    for (int i = 0; i < runs; i++) {
+        const Result& r = results[i];
+        totalTicks += r.ticks;
+        sum += r.distance;
+        distances[i] = r.distance;
+        if (r.obstacle < 0) survived++;
+        else deathsAt[r.obstacle]++;
+    }
+    sort(distances.begin(), distances.end());
+
+    seconds = max(seconds, 1e-9);
+    cout << "Playtest: " << runs << " runs from seed " << seed << " on " << threads << " threads in " << seconds << " s\n";
+    cout << "  " << runs / seconds << " runs/s, " << totalTicks / seconds << " ticks/s ("
+         << totalTicks / seconds / 60.0 << "x realtime)\n";
+    cout << "  distance: mean " << sum / runs << ", p50 " << distances[runs / 2]
+         << ", min " << distances.front() << ", max " << distances.back() << "\n";
+    cout << "  survived: " << survived << " / " << runs << "\n";
+    cout << "  deaths per obstacle:";
+    for (int i = 0; i < LevelLayout::MAX_OBSTACLES; i++)
+        if (deathsAt[i] > 0) cout << " #" << i << "=" << deathsAt[i];
+    cout << "\n";
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Headless bot playtests. Each run generates a level from its own seed and
+// lets a simple bot (hold right, jump at whatever is ahead) play it with
+// the same PlayerPhysics the game uses, until it hits an obstacle, reaches
+// the end of the level or runs out of ticks. Runs are spread over all
+// cores; nothing touches SFML windows, textures or audio.
+class Playtester {
+public:
+    struct Result {
+        float distance;     // how far right of the spawn it got
+        int ticks;
+        int obstacle;       // ordinal of the obstacle it died on, -1 if it survived
+    };
+
+    static const int MAX_TICKS = 60 * 180;
+
+    // prints the summary to stdout, returns false if nothing ran
+    static bool run(int runs, uint32_t seed, unsigned threads = 0);
+
+    // one run, exposed so a single seed can be replayed
+    static Result playOne(uint32_t seed);
+};
@@ -0,0 +1,53 @@
+#include "QualityGovernor.h"
+
+#include <algorithm>
+
+using namespace std;
+
+const QualityTier QualityGovernor::tiers[TIER_COUNT] = {
+    { "low",    20, 0.25f, 3, false },
+    { "medium", 40, 0.5f,  4, true },
+    { "high",   60, 0.75f, 5, true },
+    { "ultra",  80, 1.f,   5, true },
+};
+
+bool QualityGovernor::addFrame(float work)
+{
+    tierFrames++;
+    frames[next] = work;
+    next = (next + 1) % WINDOW;
+    if (count < WINDOW) { count++; return false; }
+
+    float sorted[WINDOW];
+    copy(frames, frames + WINDOW, sorted);
+    float mean = 0.f;
+    for (float f : sorted) mean += f;
+    mean /= WINDOW;
+    nth_element(sorted, sorted + WINDOW * 9 / 10, sorted + WINDOW);
+    float p90 = sorted[WINDOW * 9 / 10];
+
+    // work close to the budget is already a miss once anything spikes,
+    // headroom means the next tier's extra cost still fits
+    int newTier = tier;
+    if ((mean > targetFrameTime * 0.95f || p90 > targetFrameTime * 1.1f) && tier > 0) {
+        newTier = tier - 1;
+        // a tier that didn't hold is tried again later
+        if (probation && tierFrames < stableNeeded[tier])
+            stableNeeded[tier] = min(stableNeeded[tier] * 2, MAX_STABLE_FRAMES);
+    }
+    else if (mean < targetFrameTime * 0.7f && p90 < targetFrameTime * 0.8f) {
+        if (tier < TIER_COUNT - 1 && ++stableFrames >= stableNeeded[tier + 1]) newTier = tier + 1;
+    }
+    else {
+        stableFrames = 0;
+    }
+
+    if (newTier == tier) return false;
+
+    probation = newTier > tier;
+    tier = newTier;
+    count = 0;          // judge the new tier on its own frames
+    stableFrames = 0;
+    tierFrames = 0;
+    return true;
+}
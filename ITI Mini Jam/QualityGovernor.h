@@ -0,0 +1,38 @@
+#pragma once
+
+struct QualityTier {
+    const char* name;
+    int rainDrops;
+    float propDensity;      // fraction of props drawn
+    int parallaxLayers;
+    bool smoothTextures;
+};
+
+// Watches a rolling window of frame work times (before the limiter waits)
+// against a budget and steps the effect quality tier down quickly when we
+// miss it and back up slowly once there is real headroom again. A tier
+// that had to be left soon after stepping up to it needs twice as long
+// a stable period before it is tried again.
+class QualityGovernor {
+public:
+    static const int WINDOW = 90;
+    static const int TIER_COUNT = 4;
+    static const QualityTier tiers[TIER_COUNT];   // lowest first
+    static constexpr int STABLE_FRAMES = 300;       // five seconds of headroom before going up
+    static constexpr int MAX_STABLE_FRAMES = STABLE_FRAMES * 16;
+
+    float targetFrameTime = 1.f / 60.f;
+    int tier = TIER_COUNT - 1;
+
+    // `work`: the frame's busy time; returns true when the tier changed
+    bool addFrame(float work);
+    const QualityTier& current() const { return tiers[tier]; }
+
+private:
+    float frames[WINDOW] = {};
+    int count = 0, next = 0;
+    int stableFrames = 0;     // frames in a row with headroom since the last change
+    int tierFrames = 0;       // frames at the current tier
+    bool probation = false;   // the current tier was just stepped up to
+    int stableNeeded[TIER_COUNT] = { STABLE_FRAMES, STABLE_FRAMES, STABLE_FRAMES, STABLE_FRAMES };
+};
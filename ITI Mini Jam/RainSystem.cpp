@@ -1,5 +1,8 @@
 #include "RainSystem.h"
 
+#include "MemoryTracker.h"
+
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 
@@ -7,33 +10,41 @@ using namespace sf;
 using namespace std;
 
 RainSystem::RainSystem(int count, float W, float H)
-    : WIDTH(W), HEIGHT(H)
+    : arena(sizeof(RainDrop) * count + alignof(RainDrop)), activeCount(count), WIDTH(W), HEIGHT(H)
 {
+    MemoryScope scope(MemCategory::RainSystem);
+    drops.reserve(arena, count);
     srand(static_cast<unsigned>(time(nullptr)));
     for (int i = 0; i < count; i++) {
-        RainDrop rd;
+        RainDrop& rd = drops.emplace_back();
         rd.shape.setRadius(2.5f);
         rd.shape.setFillColor(Color(173, 216, 230, 180));
         rd.shape.setPosition(rand() % static_cast<int>(WIDTH + 500), rand() % static_cast<int>(HEIGHT));
         rd.speed = 300 + rand() % 200;
-        drops.push_back(rd);
     }
 }
 
+void RainSystem::setActiveCount(int count)
+{
+    activeCount = max(0, min(count, static_cast<int>(drops.size())));
+}
+
 void RainSystem::update(float dt)
 {
-    for (auto& rd : drops)
+    for (int i = 0; i < activeCount; i++)
     {
+        RainDrop& rd = drops[i];
         rd.shape.move(rd.speed / 2.f * -dt, rd.speed * dt);
         if (rd.shape.getPosition().y > HEIGHT)
             rd.shape.setPosition(rand() % static_cast<int>(WIDTH + 500), -10.f);
     }
 }
 
-void RainSystem::draw(RenderWindow& window)
+void RainSystem::draw(DrawTarget& target)
 {
-    for (auto& rd : drops)
-        window.draw(rd.shape);
+    DrawScope scope(DrawCategory::Rain);
+    for (int i = 0; i < activeCount; i++)
+        target.draw(drops[i].shape);
 }
 
 
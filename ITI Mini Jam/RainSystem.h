@@ -1,7 +1,8 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include <vector>
+#include "LevelArena.h"
+#include "RenderStats.h"
 
 struct RainDrop {
     sf::CircleShape shape;
@@ -10,13 +11,17 @@ struct RainDrop {
 
 class RainSystem {
 public:
-    std::vector<RainDrop> drops;
+    LevelArena arena;
+    ObjectPool<RainDrop> drops;
+    int activeCount;    // drops past this are kept but not simulated or drawn
     float WIDTH, HEIGHT;
 
     RainSystem(int count, float W, float H);
 
+    void setActiveCount(int count);
+
     void update(float dt);
-    void draw(sf::RenderWindow& window);
+    void draw(DrawTarget& target);
 };
 
 
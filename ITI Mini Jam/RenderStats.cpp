@@ -0,0 +1,163 @@
+#include "RenderStats.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    const int COUNT = static_cast<int>(DrawCategory::Count);
+    const char* names[COUNT] = { "General", "Game", "Parallax", "Rain", "Menu", "UI", "Present" };
+
+    RenderStats::Frame running, finished;
+    DrawCategory currentCategory = DrawCategory::General;
+    unsigned frameNumber = 0;
+
+    const Texture* lastTexture = nullptr;
+    BlendMode lastBlend = BlendAlpha;
+
+    ofstream logFile;
+
+    void add(DrawCounters& c, const DrawCounters& d)
+    {
+        c.draws += d.draws;
+        c.vertices += d.vertices;
+        c.textureSwitches += d.textureSwitches;
+        c.blendSwitches += d.blendSwitches;
+        c.passes += d.passes;
+    }
+}
+
+void RenderStats::beginFrame()
+{
+    finished = running;
+    running = Frame();
+    lastTexture = nullptr;
+    lastBlend = BlendAlpha;
+
+    if (logFile) {
+        const DrawCounters& t = finished.total;
+        logFile << frameNumber << ',' << t.draws << ',' << t.vertices << ',' << t.textureSwitches
+            << ',' << t.blendSwitches << ',' << t.passes;
+        for (int i = 0; i < COUNT; i++) logFile << ',' << finished.byCategory[i].draws;
+        logFile << '\n';
+    }
+    frameNumber++;
+}
+
+const RenderStats::Frame& RenderStats::lastFrame()
+{
+    return finished;
+}
+
+const RenderStats::Frame& RenderStats::runningFrame()
+{
+    return running;
+}
+
+void RenderStats::onDraw(const Texture* texture, const BlendMode& blend, size_t vertices)
+{
+    DrawCounters d;
+    d.draws = 1;
+    d.vertices = static_cast<unsigned>(vertices);
+    d.textureSwitches = texture != lastTexture ? 1 : 0;
+    d.blendSwitches = blend != lastBlend ? 1 : 0;
+    lastTexture = texture;
+    lastBlend = blend;
+
+    add(running.total, d);
+    add(running.byCategory[static_cast<int>(currentCategory)], d);
+}
+
+void RenderStats::onPass()
+{
+    running.total.passes++;
+    running.byCategory[static_cast<int>(currentCategory)].passes++;
+    // a new target starts without our texture bound
+    lastTexture = nullptr;
+}
+
+DrawCategory RenderStats::current()
+{
+    return currentCategory;
+}
+
+void RenderStats::setCurrent(DrawCategory c)
+{
+    currentCategory = c;
+}
+
+bool RenderStats::openLog(const string& path)
+{
+    logFile.open(path);
+    if (!logFile) {
+        cerr << "Warning: can't write draw stats " << path << "\n";
+        return false;
+    }
+    logFile << "frame,draws,vertices,texture_switches,blend_switches,passes";
+    for (int i = 0; i < COUNT; i++) logFile << ",draws_" << names[i];
+    logFile << '\n';
+    return true;
+}
+
+void RenderStats::report(ostream& out)
+{
+    auto row = [&out](const char* name, const DrawCounters& c) {
+        out << left << setw(12) << name << right << setw(8) << c.draws << setw(10) << c.vertices
+            << setw(10) << c.textureSwitches << setw(8) << c.blendSwitches << setw(8) << c.passes << "\n";
+    };
+
+    out << left << setw(12) << "subsystem" << right << setw(8) << "draws" << setw(10) << "vertices"
+        << setw(10) << "textures" << setw(8) << "blends" << setw(8) << "passes" << "\n";
+    for (int i = 0; i < COUNT; i++) row(names[i], finished.byCategory[i]);
+    row("total", finished.total);
+}
+
+void DrawTarget::clear(const Color& color)
+{
+    target.clear(color);
+    RenderStats::onPass();
+}
+
+void DrawTarget::draw(const Sprite& sprite, const RenderStates& states)
+{
+    target.draw(sprite, states);
+    RenderStats::onDraw(sprite.getTexture(), states.blendMode, 4);
+}
+
+void DrawTarget::draw(const Shape& shape, const RenderStates& states)
+{
+    target.draw(shape, states);
+    size_t points = shape.getPointCount();
+    RenderStats::onDraw(shape.getTexture(), states.blendMode, points + 2);        // fill fan
+    if (shape.getOutlineThickness() != 0.f)
+        RenderStats::onDraw(nullptr, states.blendMode, (points + 1) * 2);         // outline strip
+}
+
+void DrawTarget::draw(const Text& text, const RenderStates& states)
+{
+    target.draw(text, states);
+    const Font* font = text.getFont();
+    if (!font) return;      // sf::Text draws nothing without a font
+    RenderStats::onDraw(&font->getTexture(text.getCharacterSize()), states.blendMode, text.getString().getSize() * 6);
+}
+
+void DrawTarget::draw(const VertexArray& vertices, const RenderStates& states)
+{
+    target.draw(vertices, states);
+    RenderStats::onDraw(states.texture, states.blendMode, vertices.getVertexCount());
+}
+
+void DrawTarget::draw(const Vertex* vertices, size_t count, PrimitiveType type, const RenderStates& states)
+{
+    target.draw(vertices, count, type, states);
+    RenderStats::onDraw(states.texture, states.blendMode, count);
+}
+
+void DrawTarget::draw(const Drawable& drawable, const RenderStates& states)
+{
+    target.draw(drawable, states);
+    RenderStats::onDraw(states.texture, states.blendMode, 0);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+enum class DrawCategory { General, Game, Parallax, Rain, Menu, UI, Present, Count };
+
+struct DrawCounters {
+    unsigned draws = 0;
+    unsigned vertices = 0;
+    unsigned textureSwitches = 0;
+    unsigned blendSwitches = 0;
+    unsigned passes = 0;        // target clears, i.e. full-screen passes
+};
+
+// Per-frame draw statistics. Every draw goes through a DrawTarget, which
+// forwards it to the real sf::RenderTarget and charges it to the category
+// of the innermost DrawScope. Texture and blend switches are counted
+// against the previous draw of the frame.
+class RenderStats {
+public:
+    struct Frame {
+        DrawCounters total;
+        DrawCounters byCategory[static_cast<int>(DrawCategory::Count)];
+    };
+
+    // closes the running frame (logging it if a log is open) and starts a new one
+    static void beginFrame();
+    static const Frame& lastFrame();
+    // counters of the frame being drawn so far
+    static const Frame& runningFrame();
+
+    static void onDraw(const sf::Texture* texture, const sf::BlendMode& blend, size_t vertices);
+    static void onPass();
+
+    static DrawCategory current();
+    static void setCurrent(DrawCategory c);
+
+    // one CSV line per frame: frame, totals, then draws per category
+    static bool openLog(const std::string& path);
+    static void report(std::ostream& out);
+};
+
+// charges draws to `c` until it goes out of scope
+class DrawScope {
+public:
+    explicit DrawScope(DrawCategory c) : previous(RenderStats::current()) { RenderStats::setCurrent(c); }
+    ~DrawScope() { RenderStats::setCurrent(previous); }
+
+    DrawScope(const DrawScope&) = delete;
+    DrawScope& operator=(const DrawScope&) = delete;
+
+private:
+    DrawCategory previous;
+};
+
+// Counting front for an sf::RenderTarget. The overloads know how many
+// vertices and which texture SFML uses for each drawable type; other
+// drawables are counted as one draw of unknown size.
+class DrawTarget {
+public:
+    explicit DrawTarget(sf::RenderTarget& target) : target(target) {}
+
+    void clear(const sf::Color& color = sf::Color::Black);
+
+    void draw(const sf::Sprite& sprite, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(const sf::Shape& shape, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(const sf::Text& text, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(const sf::VertexArray& vertices, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(const sf::Vertex* vertices, size_t count, sf::PrimitiveType type, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default);
+
+    sf::RenderTarget& target;
+};
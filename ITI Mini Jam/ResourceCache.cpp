@@ -0,0 +1,102 @@
+#include "ResourceCache.h"
+
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+using namespace sf;
+using namespace std;
+
+namespace {
+    struct Resource {
+        unique_ptr<Texture> texture;
+        vector<char> fontBytes;     // what a preloaded font reads from, freed after it
+        unique_ptr<Font> font;
+        MemCategory category;
+        int refs = 0;
+    };
+
+    // resources are only touched from the main thread
+    unordered_map<string, Resource> resources;
+}
+
+const Texture& ResourceCache::acquireTexture(const string& path, MemCategory category)
+{
+    Resource& r = resources[path];
+    if (!r.texture) {
+        MemoryScope scope(category);
+        r.texture = make_unique<Texture>();
+        r.category = category;
+        if (AssetPack::loadTexture(*r.texture, path))
+            MemoryTracker::addTexture(category, *r.texture);
+        else
+            cerr << "Warning: can't load " << path << "\n";
+    }
+    r.refs++;
+    return *r.texture;
+}
+
+const Font& ResourceCache::acquireFont(const string& path, MemCategory category)
+{
+    Resource& r = resources[path];
+    if (!r.font) {
+        MemoryScope scope(category);
+        r.font = make_unique<Font>();
+        r.category = category;
+        if (!AssetPack::loadFont(*r.font, path, r.fontBytes))
+            cerr << "Warning: can't load " << path << "\n";
+    }
+    r.refs++;
+    return *r.font;
+}
+
+void ResourceCache::release(const string& path)
+{
+    auto it = resources.find(path);
+    if (it != resources.end() && it->second.refs > 0)
+        it->second.refs--;
+}
+
+void ResourceCache::collect(const vector<string>& keep)
+{
+    for (auto it = resources.begin(); it != resources.end();) {
+        Resource& r = it->second;
+        if (r.refs > 0 || find(keep.begin(), keep.end(), it->first) != keep.end()) {
+            ++it;
+            continue;
+        }
+        if (r.texture) MemoryTracker::removeTexture(r.category, *r.texture);
+        it = resources.erase(it);
+    }
+}
+
+bool ResourceCache::isResident(const string& path)
+{
+    return resources.find(path) != resources.end();
+}
+
+size_t ResourceCache::residentCount()
+{
+    return resources.size();
+}
+
+ResourceSet::~ResourceSet()
+{
+    for (auto& path : held)
+        ResourceCache::release(path);
+}
+
+const Texture& ResourceSet::texture(const string& path)
+{
+    held.push_back(path);
+    return ResourceCache::acquireTexture(path, category);
+}
+
+const Font& ResourceSet::font(const string& path)
+{
+    held.push_back(path);
+    return ResourceCache::acquireFont(path, category);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+#include "MemoryTracker.h"
+
+// Textures and fonts shared between scenes, by asset path and refcounted.
+// A resource is loaded on its first acquire; once nothing holds it, it
+// stays until the next collect() so a scene transition can hand it over
+// without a reload. A failed load warns once and gives an empty resource.
+class ResourceCache {
+public:
+    static const sf::Texture& acquireTexture(const std::string& path, MemCategory category);
+    static const sf::Font& acquireFont(const std::string& path, MemCategory category);
+    static void release(const std::string& path);
+
+    // frees every resource nothing holds, except those in `keep`
+    static void collect(const std::vector<std::string>& keep = {});
+    // loaded, held or not; acquiring it won't touch the disk
+    static bool isResident(const std::string& path);
+    // number of resources currently loaded
+    static size_t residentCount();
+};
+
+// One owner's references into the ResourceCache, released together when
+// it goes away. Declared before the members that point into it.
+class ResourceSet {
+public:
+    explicit ResourceSet(MemCategory category) : category(category) {}
+    ~ResourceSet();
+
+    ResourceSet(const ResourceSet&) = delete;
+    ResourceSet& operator=(const ResourceSet&) = delete;
+
+    const sf::Texture& texture(const std::string& path);
+    const sf::Font& font(const std::string& path);
+
+private:
+    MemCategory category;
+    std::vector<std::string> held;
+};
@@ -0,0 +1,108 @@
+#include "Scene.h"
+
+#include "AssetPack.h"
+#include "ResourceCache.h"
+
+using namespace sf;
+using namespace std;
+
+void SceneStack::queue(Pending kind, Factory make, const vector<string>& assets)
+{
+    // the first request of a frame wins, the scenes only ask once
+    if (pending != None) return;
+    pending = kind;
+    next = move(make);
+    nextAssets = assets;
+
+    // what the cache still has is handed over by commit(), a decode of it
+    // would never be taken
+    vector<string> decode;
+    for (const string& path : nextAssets)
+        if (!ResourceCache::isResident(path)) decode.push_back(path);
+    if (!decode.empty()) AssetPack::preload(decode);
+}
+
+void SceneStack::push(Factory make, const vector<string>& assets)
+{
+    queue(Push, move(make), assets);
+}
+
+void SceneStack::pop()
+{
+    queue(Pop, nullptr, {});
+}
+
+void SceneStack::replace(Factory make, const vector<string>& assets)
+{
+    queue(Replace, move(make), assets);
+}
+
+void SceneStack::replaceAll(Factory make, const vector<string>& assets)
+{
+    queue(ReplaceAll, move(make), assets);
+}
+
+void SceneStack::drop()
+{
+    scenes.back()->exit();
+    scenes.pop_back();
+}
+
+void SceneStack::commit()
+{
+    Pending kind = pending;
+    pending = None;
+    if (kind == None) return;
+
+    if (kind == Pop || kind == Replace) {
+        if (!scenes.empty()) drop();
+    }
+    else if (kind == ReplaceAll) {
+        while (!scenes.empty()) drop();
+    }
+    else if (!scenes.empty()) {
+        scenes.back()->suspend();
+    }
+
+    // free before the next scene loads, but don't reload what it shares
+    ResourceCache::collect(nextAssets);
+
+    if (next) {
+        scenes.push_back(next());
+        scenes.back()->enter();
+    }
+    else if (!scenes.empty()) {
+        scenes.back()->resume();
+    }
+
+    next = nullptr;
+    nextAssets.clear();
+    AssetPack::finishPreload();
+}
+
+void SceneStack::handleEvent(const Event& e)
+{
+    if (!scenes.empty()) scenes.back()->handleEvent(e);
+}
+
+void SceneStack::update(float dt)
+{
+    if (!scenes.empty()) scenes.back()->update(dt);
+}
+
+void SceneStack::draw(DrawTarget& screen)
+{
+    size_t first = scenes.size();
+    while (first > 0) {
+        first--;
+        if (!scenes[first]->isOverlay()) break;
+    }
+    for (size_t i = first; i < scenes.size(); i++)
+        scenes[i]->draw(screen);
+}
+
+void SceneStack::setQuality(const QualityTier& q)
+{
+    for (auto& s : scenes)
+        s->setQuality(q);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <climits>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "QualityGovernor.h"
+#include "RenderStats.h"
+
+// One screen of the game. A scene holds its resources (ResourceSet or
+// owned assets) for exactly as long as it is on the SceneStack, and lists
+// them in assets() so the stack can decode them ahead of a transition.
+class Scene {
+public:
+    virtual ~Scene() = default;
+
+    virtual void enter() {}      // now on the stack, constructed and resident
+    virtual void exit() {}       // about to be dropped
+    virtual void suspend() {}    // another scene was pushed on top
+    virtual void resume() {}     // the scene on top was popped
+
+    // only the top scene gets events and updates
+    virtual void handleEvent(const sf::Event& e) {}
+    virtual void update(float dt) {}
+    virtual void draw(DrawTarget& screen) = 0;
+    virtual void setQuality(const QualityTier& q) {}
+
+    // drawn on top of the scene below it
+    virtual bool isOverlay() const { return false; }
+    // false if nothing changes without input, the frame rate can drop
+    virtual bool isAnimated() const { return false; }
+    // input tick of the gameplay on screen, UINT_MAX when there is none
+    virtual unsigned shownTick() const { return UINT_MAX; }
+    // true while a simulation consumes the input, Main drains it otherwise
+    virtual bool isSimulating() { return false; }
+};
+
+// Owns the scenes. Transitions are queued by the scenes themselves and
+// applied by commit() between frames; queueing one starts decoding the
+// incoming scene's assets. On commit the outgoing scene is dropped and
+// whatever no remaining or incoming scene uses is freed before the new
+// one loads, so resident memory peaks at the largest scene rather than
+// at the sum of them.
+class SceneStack {
+public:
+    using Factory = std::function<std::unique_ptr<Scene>()>;
+
+    void push(Factory make, const std::vector<std::string>& assets = {});
+    void pop();
+    // pops the top scene (or every scene) and pushes the new one; these
+    // are the slow transitions that Main hides behind a fade
+    void replace(Factory make, const std::vector<std::string>& assets = {});
+    void replaceAll(Factory make, const std::vector<std::string>& assets = {});
+
+    bool hasPending() const { return pending != None; }
+    bool pendingIsSlow() const { return pending == Replace || pending == ReplaceAll; }
+    void commit();
+
+    bool empty() const { return scenes.empty(); }
+    Scene& top() const { return *scenes.back(); }
+
+    void handleEvent(const sf::Event& e);
+    void update(float dt);
+    // draws the top scene over every overlay it sits on
+    void draw(DrawTarget& screen);
+    void setQuality(const QualityTier& q);
+
+private:
+    enum Pending { None, Push, Pop, Replace, ReplaceAll };
+
+    void queue(Pending kind, Factory make, const std::vector<std::string>& assets);
+    void drop();
+
+    std::vector<std::unique_ptr<Scene>> scenes;
+    Pending pending = None;
+    Factory next;
+    std::vector<std::string> nextAssets;
+};
@@ -0,0 +1,147 @@
+#include "Scenes.h"
+
+#include "FlightRecorder.h"
+#include "MemoryTracker.h"
+
+using namespace sf;
+using namespace std;
+
+MenuScene::MenuScene(SceneContext& c)
+    : ctx(c), menu(c.width, c.height, &c.sound)
+{
+}
+
+void MenuScene::update(float dt)
+{
+    int result = menu.update(ctx.window);
+    ctx.rain.update(dt);
+
+    SceneContext& c = ctx;
+    if (result == 1) // PLAY
+        ctx.scenes.replace([&c] { return make_unique<PlayScene>(c); }, PlayScene::assets());
+    else if (result == 2) // OPTIONS
+        ctx.scenes.push([&c] { return make_unique<OptionsScene>(c); }, OptionsMenu::assets());
+    else if (result == 3) // EXIT
+        ctx.window.close();
+}
+
+void MenuScene::draw(DrawTarget& screen)
+{
+    menu.draw(screen);
+    ctx.rain.draw(screen);
+}
+
+OptionsScene::OptionsScene(SceneContext& c)
+    : ctx(c), options(c.width, c.height, &c.sound)
+{
+}
+
+void OptionsScene::handleEvent(const Event& e)
+{
+    if (options.update(ctx.window, e) == 1)
+        ctx.scenes.pop();
+}
+
+void OptionsScene::draw(DrawTarget& screen)
+{
+    options.draw(screen);
+}
+
+PlayScene::PlayScene(SceneContext& c)
+    : ctx(c), hud(c.width)
+{
+    MemoryScope scope(MemCategory::Game);
+    game = make_unique<Game>(c.width, c.height, &c.sound, c.tileTerrain);
+    setQuality(c.quality.current());
+    sim = make_unique<SimThread>(*game, c.input);
+}
+
+vector<string> PlayScene::assets()
+{
+    vector<string> paths = Game::assets();
+    for (const string& path : Hud::assets()) paths.push_back(path);
+    return paths;
+}
+
+void PlayScene::enter()
+{
+    sim->resume();
+}
+
+void PlayScene::exit()
+{
+    sim->pause();
+    ctx.sound.stopSFX("run");
+}
+
+void PlayScene::resume()
+{
+    sim->restart();
+    playFrames = 0;
+}
+
+void PlayScene::handleEvent(const Event& e)
+{
+    if (e.type == Event::LostFocus) sim->pause();
+    else if (e.type == Event::GainedFocus) sim->resume();
+}
+
+void PlayScene::update(float dt)
+{
+    ctx.worldPass.adapt(ctx.scheduler.frameTime());
+    hud.addFrame(ctx.scheduler.frameTime());
+
+    if (sim->latest().died) {
+        SceneContext& c = ctx;
+        const Game& g = *game;
+        ctx.scenes.push([&c, &g] { return make_unique<GameOverScene>(c, g); }, GameOverScreen::assets());
+    }
+}
+
+void PlayScene::draw(DrawTarget& screen)
+{
+    NoAllocScope noAlloc(++playFrames > 60);
+    const WorldSnapshot& snap = sim->latest();
+    game->applySnapshot(snap);
+    tick = snap.tick;
+    DrawTarget world = ctx.worldPass.begin(ctx.window, game->getCamera());
+    game->draw(world);
+    ctx.worldPass.present(ctx.window);
+
+    hud.setDistance(game->distance());
+    hud.setScore(game->hazardsCleared());
+    ctx.window.setView(ctx.window.getDefaultView());
+    hud.draw(screen);
+
+    FlightRecorder::setCounter(Counter::Props, static_cast<uint32_t>(game->visibleTrees + game->visibleLeaves));
+    FlightRecorder::setCounter(Counter::Obstacles, static_cast<uint32_t>(game->obstacles.size()));
+}
+
+void PlayScene::setQuality(const QualityTier& q)
+{
+    game->setQuality(q.propDensity, q.parallaxLayers, q.smoothTextures);
+}
+
+GameOverScene::GameOverScene(SceneContext& c, const Game& g)
+    : ctx(c), game(g), screen(c.width, c.height)
+{
+}
+
+void GameOverScene::handleEvent(const Event& e)
+{
+    // the screen is laid out relative to the game camera
+    ctx.window.setView(game.getCamera());
+    GameOverScreen::Choice choice = screen.update(ctx.window, e);
+
+    SceneContext& c = ctx;
+    if (choice == GameOverScreen::Restart)
+        ctx.scenes.pop();
+    else if (choice == GameOverScreen::BackToMenu)
+        ctx.scenes.replaceAll([&c] { return make_unique<MenuScene>(c); }, Menu::assets());
+}
+
+void GameOverScene::draw(DrawTarget& target)
+{
+    ctx.window.setView(game.getCamera());
+    screen.draw(target, game.getCamera());
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DynamicResolution.h"
+#include "FrameScheduler.h"
+#include "Game.h"
+#include "GameOverScreen.h"
+#include "Hud.h"
+#include "InputBuffer.h"
+#include "Menu.h"
+#include "OptionsMenu.h"
+#include "QualityGovernor.h"
+#include "RainSystem.h"
+#include "Scene.h"
+#include "SimThread.h"
+#include "SoundManager.h"
+
+// What every scene gets from Main; all of it outlives the scenes.
+struct SceneContext {
+    sf::RenderWindow& window;
+    SceneStack& scenes;
+    SoundManager& sound;
+    InputBuffer& input;
+    RainSystem& rain;
+    DynamicResolution& worldPass;
+    QualityGovernor& quality;
+    const FrameScheduler& scheduler;
+    float width, height;
+    bool tileTerrain;
+};
+
+class MenuScene : public Scene {
+public:
+    explicit MenuScene(SceneContext& ctx);
+
+    void update(float dt) override;
+    void draw(DrawTarget& screen) override;
+    bool isAnimated() const override { return true; }  // rain
+
+private:
+    SceneContext& ctx;
+    Menu menu;
+};
+
+class OptionsScene : public Scene {
+public:
+    explicit OptionsScene(SceneContext& ctx);
+
+    void handleEvent(const sf::Event& e) override;
+    void draw(DrawTarget& screen) override;
+
+private:
+    SceneContext& ctx;
+    OptionsMenu options;
+};
+
+// The game world and its SimThread; dropped (and with it every level
+// entity and texture) when going back to the menu.
+class PlayScene : public Scene {
+public:
+    explicit PlayScene(SceneContext& ctx);
+
+    // game plus HUD, for prefetching
+    static std::vector<std::string> assets();
+
+    void enter() override;
+    void exit() override;
+    void resume() override;     // back from game over: restart
+
+    void handleEvent(const sf::Event& e) override;
+    void update(float dt) override;
+    void draw(DrawTarget& screen) override;
+    void setQuality(const QualityTier& q) override;
+
+    bool isAnimated() const override { return true; }
+    unsigned shownTick() const override { return tick; }
+    bool isSimulating() override { return !sim->isPaused(); }
+
+private:
+    SceneContext& ctx;
+    std::unique_ptr<Game> game;
+    std::unique_ptr<SimThread> sim;     // declared after game, stops first
+    Hud hud;
+    int playFrames = 0;     // frames since (re)start, the first ones may still warm caches
+    unsigned tick = 0;      // input tick of the snapshot on screen
+};
+
+// Drawn over the frozen PlayScene it was pushed on.
+class GameOverScene : public Scene {
+public:
+    GameOverScene(SceneContext& ctx, const Game& game);
+
+    void handleEvent(const sf::Event& e) override;
+    void draw(DrawTarget& screen) override;
+    bool isOverlay() const override { return true; }
+
+private:
+    SceneContext& ctx;
+    const Game& game;
+    GameOverScreen screen;
+};
@@ -0,0 +1,127 @@
+#include "SimThread.h"
+
+#include "FlightRecorder.h"
+#include "InputBuffer.h"
+#include "MemoryTracker.h"
+
+#include <chrono>
+
+using namespace std;
+
+SimThread::SimThread(Game& g, InputBuffer& in)
+    : game(g), input(in)
+{
+    // the render thread has something to draw before the first tick
+    publish(false);
+    snapshots.update();
+    worker = thread(&SimThread::run, this);
+}
+
+SimThread::~SimThread()
+{
+    {
+        lock_guard<mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void SimThread::pause()
+{
+    unique_lock<mutex> lock(stateMutex);
+    paused = true;
+    settled.wait(lock, [this] { return idle; });
+}
+
+void SimThread::resume()
+{
+    unique_lock<mutex> lock(stateMutex);
+    if (!paused || dead) return;
+    settled.wait(lock, [this] { return idle; });
+    publish(false);
+    paused = false;
+    lock.unlock();
+    wake.notify_one();
+}
+
+void SimThread::restart()
+{
+    pause();
+    {
+        lock_guard<mutex> lock(stateMutex);
+        game.reset();
+        dead = false;
+    }
+    resume();
+}
+
+bool SimThread::isPaused()
+{
+    lock_guard<mutex> lock(stateMutex);
+    return paused;
+}
+
+const WorldSnapshot& SimThread::latest()
+{
+    snapshots.update();
+    return snapshots.front();
+}
+
+void SimThread::publish(bool died)
+{
+    WorldSnapshot& snap = snapshots.back();
+    game.publish(snap);
+    snap.tick = input.tickCount;
+    snap.died = died;
+    snapshots.publish();
+}
+
+void SimThread::run()
+{
+    using clock = chrono::steady_clock;
+    const auto tick = chrono::duration_cast<clock::duration>(chrono::duration<float>(TICK));
+
+    auto next = clock::now();
+    int ticks = 0;      // since the last resume, the first ones may still warm caches
+
+    unique_lock<mutex> lock(stateMutex);
+    for (;;)
+    {
+        if (paused || stopping) {
+            idle = true;
+            settled.notify_all();
+            wake.wait(lock, [this] { return !paused || stopping; });
+            if (stopping) {
+                // the next play session's SimThread needs the audio ring
+                if (game.soundMgr) game.soundMgr->releaseProducer();
+                return;
+            }
+            idle = false;
+            next = clock::now();
+            ticks = 0;
+        }
+        lock.unlock();
+
+        bool died;
+        {
+            NoAllocScope noAlloc(++ticks > 60);
+            ZoneScope zone(Zone::SimTick);
+            input.beginTick();
+            died = game.update(TICK, input);
+            publish(died);
+        }
+
+        // fall back to real time instead of bursting after a stall
+        next += tick;
+        auto now = clock::now();
+        if (now - next > tick * 5) next = now;
+        this_thread::sleep_until(next);
+
+        lock.lock();
+        if (died) {
+            dead = true;
+            paused = true;
+        }
+    }
+}
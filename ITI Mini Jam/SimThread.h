@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Game.h"
+#include "TripleBuffer.h"
+
+class InputBuffer;
+
+// Runs Game::update at a fixed tick on its own thread and publishes a
+// WorldSnapshot after every tick. The render thread draws the newest
+// snapshot without locking; only pause/resume/restart synchronise.
+// Starts paused.
+class SimThread {
+public:
+    static constexpr float TICK = 1.f / 60.f;   // movement is tuned per tick
+
+    SimThread(Game& game, InputBuffer& input);
+    ~SimThread();
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    // returns once the simulation is between ticks and stays there;
+    // the game may then be touched from the calling thread
+    void pause();
+    // publishes the current state and continues ticking, no-op after a death
+    void resume();
+    // resets the game after a death (or at any time) and resumes
+    void restart();
+    bool isPaused();
+
+    // render side: newest published snapshot, never blocks
+    const WorldSnapshot& latest();
+
+private:
+    void run();
+    void publish(bool died);
+
+    Game& game;
+    InputBuffer& input;
+    TripleBuffer<WorldSnapshot> snapshots;
+
+    std::mutex stateMutex;
+    std::condition_variable wake;       // paused/stopping changed
+    std::condition_variable settled;    // the loop went idle
+    bool paused = true;
+    bool idle = false;
+    bool stopping = false;
+    bool dead = false;                  // the last tick killed the player
+    std::thread worker;
+};
@@ -1,5 +1,10 @@
 #include "SoundManager.h"
 
+#include "AssetPack.h"
+#include "FlightRecorder.h"
+#include "MemoryTracker.h"
+
+#include <chrono>
 #include <iostream>
 
 using namespace std;
@@ -7,9 +12,10 @@ using namespace sf;
 
 SoundManager::SoundManager()
 {
-    if (!menuMusic.openFromFile("Assets/SFX/BackGround.mp3"))
+    MemoryScope scope(MemCategory::SoundManager);
+    if (!AssetPack::openMusic(music[MenuTrack], "Assets/SFX/BackGround.mp3"))
         cerr << "Warning: menu_music.ogg not found\n";
-    if (!gameMusic.openFromFile("Assets/SFX/BackGround.mp3"))
+    if (!AssetPack::openMusic(music[GameTrack], "Assets/SFX/BackGround.mp3"))
         cerr << "Warning: game_music.ogg not found\n";
 
     ensureBuffer("button_click", "Assets/SFX/button_click.mp3");
@@ -18,94 +24,133 @@ SoundManager::SoundManager()
     ensureBuffer("landing", "Assets/SFX/landing.mp3");
     ensureBuffer("rain", "Assets/SFX/rain.mp3");
 
-    applyVolumes();
+    for (auto& m : music) m.setVolume(musicGain);
+    for (int i = 0; i < soundCount; i++) sounds[i].setVolume(soundGain);
+
+    worker = thread(&SoundManager::run, this);
+}
+
+SoundManager::~SoundManager()
+{
+    stopping = true;
+    worker.join();
 }
 
 void SoundManager::ensureBuffer(const string& key, const string& path, bool loop)
 {
-    SoundBuffer buf;
-    if (!buf.loadFromFile(path)) {
+    if (soundCount == MAX_SOUNDS) {
+        cerr << "Warning: too many sounds, " << key << " skipped\n";
+        return;
+    }
+    int id = soundCount++;
+    if (!AssetPack::loadSoundBuffer(buffers[id], path)) {
         cerr << "Warning: SFX " << path << " not found (key: " << key << ")\n";
     }
-    buffers[key] = move(buf);
-    sounds[key] = Sound();
-    sounds[key].setBuffer(buffers[key]);
-    sounds[key].setLoop(loop);
+    MemoryTracker::addSoundBuffer(MemCategory::SoundManager, buffers[id]);
+    sounds[id].setBuffer(buffers[id]);
+    sounds[id].setLoop(loop);
+    soundIds[key] = id;
 }
 
-void SoundManager::playMusic(const string& which, bool loop)
+int SoundManager::soundId(const string& key) const
+{
+    auto it = soundIds.find(key);
+    return it == soundIds.end() ? -1 : it->second;
+}
+
+int SoundManager::trackId(const string& which)
 {
-    if (!musicEnabled) return;
+    if (which == "menu") return MenuTrack;
+    if (which == "game") return GameTrack;
+    return -1;
+}
 
-    if (which == "menu") {
-        gameMusic.stop();
-        if (menuMusic.getStatus() != Music::Playing) {
-            menuMusic.setLoop(loop);
-            menuMusic.setVolume(musicVolume);
-            menuMusic.play();
-        }
-    }
-    else if (which == "game") {
-        menuMusic.stop();
-        if (gameMusic.getStatus() != Music::Playing) {
-            gameMusic.setLoop(loop);
-            gameMusic.setVolume(musicVolume);
-            gameMusic.play();
-        }
+void SoundManager::push(AudioOp op, int target, bool loop, float value)
+{
+    // each calling thread gets a ring of its own the first time it calls in
+    // and keeps it until it calls releaseProducer()
+    thread::id me = this_thread::get_id();
+    SpscRing<AudioCommand, RING_SIZE>* ring = nullptr;
+    for (int i = 0; i < MAX_PRODUCERS && !ring; i++)
+        if (ringOwners[i].load(memory_order_acquire) == me) ring = &rings[i];
+    for (int i = 0; i < MAX_PRODUCERS && !ring; i++) {
+        thread::id none;
+        if (ringOwners[i].compare_exchange_strong(none, me, memory_order_acq_rel)) ring = &rings[i];
     }
+
+    AudioCommand cmd = { op, static_cast<uint8_t>(target), loop, value };
+    if (!ring || !ring->push(cmd))
+        dropped.fetch_add(1, memory_order_relaxed);
+}
+
+void SoundManager::releaseProducer()
+{
+    // commands still in the ring are drained as usual, the next owner
+    // only pushes after this store
+    thread::id me = this_thread::get_id();
+    for (int i = 0; i < MAX_PRODUCERS; i++)
+        if (ringOwners[i].load(memory_order_acquire) == me)
+            ringOwners[i].store(thread::id(), memory_order_release);
+}
+
+void SoundManager::playMusic(const string& which, bool loop)
+{
+    int track = trackId(which);
+    if (!musicEnabled || track < 0) return;
+    push(AudioOp::PlayMusic, track, loop);
+}
+
+void SoundManager::crossfadeMusic(const string& which, float seconds, bool loop)
+{
+    int track = trackId(which);
+    if (!musicEnabled || track < 0) return;
+    push(AudioOp::Crossfade, track, loop, seconds);
 }
 
 void SoundManager::stopMusic()
 {
-    menuMusic.stop();
-    gameMusic.stop();
+    push(AudioOp::StopMusic);
 }
 
 void SoundManager::playSFX(const string& key, bool loop)
 {
-    if (!sfxEnabled) return;
-    auto it = sounds.find(key);
-    if (it != sounds.end()) {
-        Sound& s = it->second;
-        s.setVolume(sfxVolume);
-        s.setLoop(loop);
-        if (loop) {
-            if (s.getStatus() != Sound::Playing) s.play();
-        }
-        else {
-            s.stop();
-            s.play();
-        }
-    }
+    int id = soundId(key);
+    if (!sfxEnabled || id < 0) return;
+    push(AudioOp::PlaySound, id, loop);
 }
 
 void SoundManager::stopSFX(const string& key)
 {
-    auto it = sounds.find(key);
-    if (it != sounds.end()) {
-        it->second.stop();
-    }
+    int id = soundId(key);
+    if (id >= 0) push(AudioOp::StopSound, id);
 }
 
 bool SoundManager::isSFXPlaying(const string& key) const
 {
-    auto it = sounds.find(key);
-    if (it != sounds.end()) {
-        return it->second.getStatus() == Sound::Playing;
-    }
-    return false;
+    int id = soundId(key);
+    return id >= 0 && soundPlaying[id].load(memory_order_relaxed);
+}
+
+void SoundManager::pauseAll()
+{
+    push(AudioOp::PauseAll);
+}
+
+void SoundManager::resumeAll()
+{
+    push(AudioOp::ResumeAll);
 }
 
 void SoundManager::setMusicVolume(float vol)
 {
     musicVolume = clamp(vol, 0.f, 100.f);
-    applyVolumes();
+    push(AudioOp::SetMusicGain, 0, false, musicVolume);
 }
 
 void SoundManager::setSFXVolume(float vol)
 {
     sfxVolume = clamp(vol, 0.f, 100.f);
-    applyVolumes();
+    push(AudioOp::SetSoundGain, 0, false, sfxVolume);
 }
 
 void SoundManager::setMusicEnabled(bool enabled)
@@ -119,13 +164,125 @@ void SoundManager::setSFXEnabled(bool enabled)
     sfxEnabled = enabled;
 }
 
-void SoundManager::applyVolumes()
+void SoundManager::run()
+{
+    MemoryScope scope(MemCategory::SoundManager);
+    auto last = chrono::steady_clock::now();
+    bool warnedDropped = false;
+
+    while (!stopping.load(memory_order_relaxed))
+    {
+        {
+            ZoneScope zone(Zone::Audio);
+            AudioCommand cmd;
+            for (auto& ring : rings)
+                while (ring.pop(cmd)) execute(cmd);
+        }
+
+        // reported here, not in push(): producers may be gameplay threads.
+        // A lost stop (the run loop) keeps playing, so say so at least once
+        if (!warnedDropped && dropped.load(memory_order_relaxed) > 0) {
+            warnedDropped = true;
+            cerr << "Warning: audio commands dropped (ring full or no free ring), sounds may get stuck\n";
+        }
+
+        auto now = chrono::steady_clock::now();
+        updateFade(chrono::duration<float>(now - last).count());
+        last = now;
+
+        for (int i = 0; i < soundCount; i++)
+            soundPlaying[i].store(sounds[i].getStatus() == Sound::Playing, memory_order_relaxed);
+
+        this_thread::sleep_for(chrono::milliseconds(2));
+    }
+}
+
+void SoundManager::execute(const AudioCommand& cmd)
 {
-    menuMusic.setVolume(musicVolume);
-    gameMusic.setVolume(musicVolume);
-    for (auto& [k, s] : sounds) {
-        s.setVolume(sfxVolume);
+    switch (cmd.op)
+    {
+    case AudioOp::PlayMusic:
+    case AudioOp::Crossfade: {
+        Music& m = music[cmd.target];
+        // fading into the track that is already playing would dip it to silence
+        bool fading = cmd.op == AudioOp::Crossfade && cmd.value > 0.f && m.getStatus() != Music::Playing;
+        int other = -1;
+        for (int t = 0; t < TrackCount; t++) {
+            if (t == cmd.target) continue;
+            if (fading && music[t].getStatus() != Music::Stopped) other = t;
+            else music[t].stop();
+        }
+        fadeFrom = other;
+        fadeTo = fading ? cmd.target : -1;
+        fadeTime = 0.f;
+        fadeDuration = cmd.value;
+
+        m.setVolume(fading ? 0.f : musicGain);
+        if (m.getStatus() != Music::Playing) {
+            m.setLoop(cmd.loop);
+            m.play();
+            if (paused) m.pause();
+        }
+        break;
+    }
+    case AudioOp::StopMusic:
+        for (auto& m : music) m.stop();
+        fadeFrom = fadeTo = -1;
+        break;
+    case AudioOp::PlaySound: {
+        Sound& s = sounds[cmd.target];
+        s.setLoop(cmd.loop);
+        if (!cmd.loop) s.stop();
+        if (s.getStatus() != Sound::Playing) {
+            s.play();
+            if (paused) s.pause();
+        }
+        break;
+    }
+    case AudioOp::StopSound:
+        sounds[cmd.target].stop();
+        break;
+    case AudioOp::SetMusicGain:
+        musicGain = cmd.value;
+        for (int t = 0; t < TrackCount; t++)
+            if (t != fadeFrom && t != fadeTo) music[t].setVolume(musicGain);
+        break;
+    case AudioOp::SetSoundGain:
+        soundGain = cmd.value;
+        for (int i = 0; i < soundCount; i++) sounds[i].setVolume(soundGain);
+        break;
+    case AudioOp::PauseAll:
+        paused = true;
+        for (auto& m : music)
+            if (m.getStatus() == Music::Playing) m.pause();
+        for (int i = 0; i < soundCount; i++)
+            if (sounds[i].getStatus() == Sound::Playing) sounds[i].pause();
+        break;
+    case AudioOp::ResumeAll:
+        // nothing else pauses, so anything paused was paused by PauseAll
+        paused = false;
+        for (auto& m : music)
+            if (m.getStatus() == Music::Paused) m.play();
+        for (int i = 0; i < soundCount; i++)
+            if (sounds[i].getStatus() == Sound::Paused) sounds[i].play();
+        break;
     }
 }
 
+void SoundManager::updateFade(float dt)
+{
+    if (fadeTo < 0 || paused) return;
+
+    fadeTime += dt;
+    float t = min(fadeTime / fadeDuration, 1.f);
+    music[fadeTo].setVolume(musicGain * t);
+    if (fadeFrom >= 0) music[fadeFrom].setVolume(musicGain * (1.f - t));
 
+    if (t >= 1.f) {
+        if (fadeFrom >= 0) {
+            music[fadeFrom].stop();
+            music[fadeFrom].setVolume(musicGain);
+        }
+        fadeFrom = fadeTo = -1;
+    }
+}
@@ -2,17 +2,36 @@
 
 #include <SFML/Audio.hpp>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <thread>
 
+#include "SpscRing.h"
+
+enum class AudioOp : uint8_t { PlayMusic, StopMusic, Crossfade, PlaySound, StopSound, SetMusicGain, SetSoundGain, PauseAll, ResumeAll };
+
+struct AudioCommand {
+    AudioOp op;
+    uint8_t target;     // music track or sound id
+    bool loop;
+    float value;        // gain (0-100) or crossfade seconds
+};
+
+// Gameplay and UI code call the methods below from any thread; each call
+// only pushes a small AudioCommand into that thread's lock-free ring. A
+// dedicated audio thread drains the rings and owns every SFML audio
+// object, so no OpenAL call (or its locks) ever runs on the simulation
+// or render thread.
 class SoundManager {
 public:
-    sf::Music menuMusic;
-    sf::Music gameMusic;
-
-    std::map<std::string, sf::SoundBuffer> buffers;
-    std::map<std::string, sf::Sound> sounds;
+    enum Track { MenuTrack, GameTrack, TrackCount };
+    static const int MAX_SOUNDS = 16;
+    static const int MAX_PRODUCERS = 4;     // threads that may issue commands
+    static const size_t RING_SIZE = 256;
 
+    // last values set, for the options screen
     float musicVolume = 60.f;
     float sfxVolume = 80.f;
 
@@ -20,22 +39,67 @@ public:
     bool sfxEnabled = true;
 
     SoundManager();
+    ~SoundManager();
 
-    void ensureBuffer(const std::string& key, const std::string& path, bool loop = false);
+    SoundManager(const SoundManager&) = delete;
+    SoundManager& operator=(const SoundManager&) = delete;
 
     void playMusic(const std::string& which, bool loop = true);
+    // fades the playing track out while `which` fades in
+    void crossfadeMusic(const std::string& which, float seconds, bool loop = true);
     void stopMusic();
 
     void playSFX(const std::string& key, bool loop = false);
     void stopSFX(const std::string& key);
+    // as of the audio thread's last pass, a couple of ms behind
     bool isSFXPlaying(const std::string& key) const;
 
+    // holds everything that is playing (window in the background) and picks it up again
+    void pauseAll();
+    void resumeAll();
+
     void setMusicVolume(float vol);
     void setSFXVolume(float vol);
     void setMusicEnabled(bool enabled);
     void setSFXEnabled(bool enabled);
 
-    void applyVolumes();
-};
+    // gives the calling thread's ring back, producer threads that come and
+    // go (one SimThread per play session) call it before they exit
+    void releaseProducer();
 
+    // commands lost because a ring was full or none was free; the audio
+    // thread warns the first time it happens
+    size_t droppedCommands() const { return dropped.load(std::memory_order_relaxed); }
 
+private:
+    void ensureBuffer(const std::string& key, const std::string& path, bool loop = false);
+    int soundId(const std::string& key) const;
+    static int trackId(const std::string& which);
+
+    void push(AudioOp op, int target = 0, bool loop = false, float value = 0.f);
+
+    // audio thread
+    void run();
+    void execute(const AudioCommand& cmd);
+    void updateFade(float dt);
+
+    // loaded by the constructor, then only touched by the audio thread
+    sf::Music music[TrackCount];
+    sf::SoundBuffer buffers[MAX_SOUNDS];
+    sf::Sound sounds[MAX_SOUNDS];
+    int soundCount = 0;
+    std::map<std::string, int> soundIds;    // read-only once the thread runs
+
+    // audio thread state
+    float musicGain = 60.f, soundGain = 80.f;
+    bool paused = false;
+    int fadeFrom = -1, fadeTo = -1;
+    float fadeTime = 0.f, fadeDuration = 0.f;
+
+    SpscRing<AudioCommand, RING_SIZE> rings[MAX_PRODUCERS];
+    std::atomic<std::thread::id> ringOwners[MAX_PRODUCERS];
+    std::atomic<bool> soundPlaying[MAX_SOUNDS];
+    std::atomic<size_t> dropped{ 0 };
+    std::atomic<bool> stopping{ false };
+    std::thread worker;
+};
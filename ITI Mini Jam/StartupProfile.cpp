@@ -0,0 +1,119 @@
+#include "StartupProfile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    using Clock = chrono::steady_clock;
+
+    struct Span {
+        string name;
+        StartupProfile::Phase phase;
+        double begin, end;
+        int thread;
+    };
+
+    Clock::time_point origin = Clock::now();
+    atomic<bool> recording{ false };
+    double interactiveAt = 0.0;
+    mutex spansLock;
+    vector<Span> spans;
+
+    double ms(double s) { return s * 1000.0; }
+}
+
+void StartupProfile::start()
+{
+    origin = Clock::now();
+    lock_guard<mutex> guard(spansLock);
+    spans.clear();
+    spans.reserve(128);
+    recording = true;
+}
+
+double StartupProfile::now()
+{
+    return chrono::duration<double>(Clock::now() - origin).count();
+}
+
+bool StartupProfile::active()
+{
+    return recording;
+}
+
+void StartupProfile::record(const string& name, Phase phase, double begin, double end, int thread)
+{
+    if (!recording) return;
+    lock_guard<mutex> guard(spansLock);
+    spans.push_back({ name, phase, begin, end, thread });
+}
+
+void StartupProfile::finish(ostream& out)
+{
+    if (!recording) return;
+    interactiveAt = now();
+    recording = false;
+    report(out);
+}
+
+void StartupProfile::report(ostream& out)
+{
+    lock_guard<mutex> guard(spansLock);
+
+    // the critical path is the main thread: its steps, and within them
+    // the waits for loaders and the uploads
+    double steps = 0.0, waits = 0.0, uploads = 0.0, decodeBusy = 0.0;
+    int loaders = 0;
+    for (auto& s : spans) {
+        double d = s.end - s.begin;
+        if (s.phase == Step) steps += d;
+        else if (s.phase == Wait) waits += d;
+        else if (s.phase == Upload) uploads += d;
+        else if (s.phase == Decode) decodeBusy += d;
+        loaders = max(loaders, s.thread);
+    }
+
+    out << fixed << setprecision(1);
+    out << "Startup: interactive after " << ms(interactiveAt) << " ms\n";
+    out << "  main thread steps " << ms(steps) << " ms, of which waiting for loaders " << ms(waits)
+        << " ms, uploads " << ms(uploads) << " ms\n";
+    out << "  decode " << ms(decodeBusy) << " ms of work on " << loaders << " loader threads\n";
+
+    out << "  main thread:\n";
+    for (auto& s : spans)
+        if (s.phase == Step)
+            out << "    " << setw(7) << ms(s.begin) << " +" << setw(6) << ms(s.end - s.begin) << " ms  " << s.name << "\n";
+
+    // per asset: what each phase cost, slowest first
+    struct Row { double decode = 0, wait = 0, upload = 0, load = 0; int thread = 0; };
+    map<string, Row> rows;
+    for (auto& s : spans) {
+        if (s.phase == Step) continue;
+        Row& r = rows[s.name];
+        double d = s.end - s.begin;
+        if (s.phase == Decode) { r.decode += d; r.thread = s.thread; }
+        else if (s.phase == Wait) r.wait += d;
+        else if (s.phase == Upload) r.upload += d;
+        else r.load += d;
+    }
+    vector<pair<string, Row>> sorted(rows.begin(), rows.end());
+    sort(sorted.begin(), sorted.end(), [](const pair<string, Row>& a, const pair<string, Row>& b) {
+        return a.second.wait + a.second.upload + a.second.load > b.second.wait + b.second.upload + b.second.load;
+    });
+
+    out << "  assets (main thread cost first): decode / wait / upload / load ms\n";
+    for (auto& [name, r] : sorted) {
+        out << "    " << setw(6) << ms(r.decode) << " " << setw(6) << ms(r.wait) << " " << setw(6) << ms(r.upload)
+            << " " << setw(6) << ms(r.load) << "  " << name;
+        if (r.thread) out << " (loader " << r.thread << ")";
+        out << "\n";
+    }
+    out << defaultfloat << setprecision(6);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+// Timeline of everything that happens before the menu is interactive:
+// main-thread steps (window, each subsystem), and per asset the decode
+// on a loader thread, the time the main thread spent waiting for it and
+// the upload. Times are seconds since the profile started. Recording
+// stops at finish(), which prints the breakdown once.
+class StartupProfile {
+public:
+    enum Phase { Step, Decode, Wait, Upload, Load };
+
+    static void start();
+    static double now();
+    static bool active();
+
+    // safe from any thread; `thread` is 0 for the main thread, loaders count from 1
+    static void record(const std::string& name, Phase phase, double begin, double end, int thread = 0);
+
+    // time to interactive; logs the report to `out`
+    static void finish(std::ostream& out);
+    static void report(std::ostream& out);
+};
+
+// records a main-thread step (or any phase) from construction to destruction
+class StartupScope {
+public:
+    explicit StartupScope(const char* name, StartupProfile::Phase phase = StartupProfile::Step, int thread = 0)
+        : name(name), phase(phase), thread(thread), begin(StartupProfile::now()) {}
+    ~StartupScope() { StartupProfile::record(name, phase, begin, StartupProfile::now(), thread); }
+
+    StartupScope(const StartupScope&) = delete;
+    StartupScope& operator=(const StartupScope&) = delete;
+
+private:
+    const char* name;
+    StartupProfile::Phase phase;
+    int thread;
+    double begin;
+};
@@ -0,0 +1,119 @@
+#include "TileGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace sf;
+using namespace std;
+
+void TileGrid::create(float left_, float top_, float tileSize_, int cols_, int rows_)
+{
+    left = left_;
+    top = top_;
+    tileSize = tileSize_;
+    cols = max(cols_, 0);
+    rows = max(rows_, 0);
+    cells.assign(static_cast<size_t>(cols) * rows, Empty);
+}
+
+TileGrid::Tile TileGrid::at(int col, int row) const
+{
+    if (col < 0 || row < 0 || col >= cols || row >= rows) return Empty;
+    return static_cast<Tile>(cells[static_cast<size_t>(row) * cols + col]);
+}
+
+void TileGrid::set(int col, int row, Tile tile)
+{
+    if (col < 0 || row < 0 || col >= cols || row >= rows) return;
+    cells[static_cast<size_t>(row) * cols + col] = tile;
+}
+
+void TileGrid::fill(int col0, int row0, int col1, int row1, Tile tile)
+{
+    for (int r = max(row0, 0); r <= min(row1, rows - 1); r++)
+        for (int c = max(col0, 0); c <= min(col1, cols - 1); c++)
+            cells[static_cast<size_t>(r) * cols + c] = tile;
+}
+
+int TileGrid::colAt(float x) const
+{
+    return static_cast<int>(floor((x - left) / tileSize));
+}
+
+int TileGrid::rowAt(float y) const
+{
+    return static_cast<int>(floor((y - top) / tileSize));
+}
+
+FloatRect TileGrid::cellRect(int col, int row) const
+{
+    return FloatRect(left + col * tileSize, top + row * tileSize, tileSize, tileSize);
+}
+
+float TileGrid::surfaceY(int col, int row, float x) const
+{
+    float cellLeft = left + col * tileSize;
+    float cellTop = top + row * tileSize;
+    float dx = min(max(x - cellLeft, 0.f), tileSize);
+    return at(col, row) == SlopeUp ? cellTop + tileSize - dx : cellTop + dx;
+}
+
+void TileGrid::resolve(PlayerBody& body, const PlayerTuning& tuning) const
+{
+    if (cells.empty()) return;
+
+    FloatRect hb = body.bounds(tuning);
+    const int c0 = max(colAt(hb.left), 0);
+    const int c1 = min(colAt(hb.left + hb.width), cols - 1);
+    const int r0 = max(rowAt(hb.top), 0);
+    const int r1 = min(rowAt(hb.top + hb.height), rows - 1);
+    if (c0 > c1 || r0 > r1) return;
+
+    // last tick on the ground and not jumping: may climb ledges and stick
+    // to slopes going down
+    const bool grounded = body.groundTimer > 0.f && body.velY >= 0.f;
+
+    // top to bottom, so a ledge's top cell lifts the body before the cells
+    // under it get a chance to push it sideways
+    for (int r = r0; r <= r1; r++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            if (at(c, r) != Solid) continue;
+            // the slope above stands the body on this cell's surface
+            Tile above = at(c, r - 1);
+            if (above == SlopeUp || above == SlopeDown) continue;
+
+            FloatRect cell = cellRect(c, r);
+            hb = body.bounds(tuning);
+            float rise = hb.top + hb.height - cell.top;
+            if (grounded && hb.intersects(cell) && rise > 0.f && rise <= STEP_UP * tileSize && above == Empty) {
+                body.y -= rise;
+                body.velY = 0.f;
+                body.onGround = true;
+                continue;
+            }
+            resolveCollision(body, tuning, cell);
+        }
+    }
+
+    if (body.velY < 0.f) return;
+
+    // slopes: stand the feet on the surface under the body's center
+    hb = body.bounds(tuning);
+    const float feet = hb.top + hb.height;
+    const float snap = grounded ? tuning.speed + 1.f : 0.f;
+    const int c = colAt(body.x);
+    for (int r = rowAt(feet - tileSize); r <= rowAt(feet + snap); r++)
+    {
+        Tile t = at(c, r);
+        if (t != SlopeUp && t != SlopeDown) continue;
+        float surface = surfaceY(c, r, body.x);
+        if (feet >= surface - snap && feet <= surface + tileSize) {
+            body.y += surface - feet;
+            body.velY = 0.f;
+            body.onGround = true;
+            return;
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "PlayerPhysics.h"
+
+// Terrain as a grid of one-byte cells: solid, empty, or a 45 degree slope
+// filling the lower-right (SlopeUp) or lower-left (SlopeDown) half of the
+// cell. Collision only looks at the cells under the hitbox, so a query
+// costs the same however long and irregular the terrain is, and a screen
+// of it is a few hundred bytes.
+class TileGrid {
+public:
+    enum Tile : uint8_t { Empty, Solid, SlopeUp, SlopeDown };
+
+    float left = 0.f, top = 0.f;
+    float tileSize = 25.f;
+    int cols = 0, rows = 0;
+    std::vector<uint8_t> cells;     // row major
+
+    void create(float left, float top, float tileSize, int cols, int rows);
+    bool empty() const { return cells.empty(); }
+
+    // outside the grid is empty
+    Tile at(int col, int row) const;
+    void set(int col, int row, Tile tile);
+    // inclusive cell range, clipped to the grid
+    void fill(int col0, int row0, int col1, int row1, Tile tile);
+
+    int colAt(float x) const;
+    int rowAt(float y) const;
+    float right() const { return left + cols * tileSize; }
+    float bottom() const { return top + rows * tileSize; }
+    sf::FloatRect cellRect(int col, int row) const;
+
+    // height of a slope cell's surface at x (clamped to the cell)
+    float surfaceY(int col, int row, float x) const;
+
+    // pushes the body out of solid cells (stepping up ledges no taller
+    // than STEP_UP tiles while grounded) and stands it on slopes
+    void resolve(PlayerBody& body, const PlayerTuning& tuning) const;
+
+    static constexpr float STEP_UP = 1.5f;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+
+// Single-producer/single-consumer handoff of the latest value. The
+// producer fills back() and publishes it; the consumer picks up the
+// newest published value with update() and reads front(). Neither side
+// ever waits for the other: there is always a spare slot to write into,
+// and values nobody picked up are simply overwritten.
+template<class T>
+class TripleBuffer {
+public:
+    // producer side
+    T& back() { return slots[backIndex]; }
+    void publish()
+    {
+        unsigned previous = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel);
+        backIndex = previous & INDEX;
+    }
+
+    // consumer side: true if a newer value was picked up
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        unsigned previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX;
+        return true;
+    }
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static const unsigned INDEX = 3, FRESH = 4;
+
+    T slots[3] = {};
+    unsigned backIndex = 0, frontIndex = 1;
+    std::atomic<unsigned> middle{ 2 };
+};
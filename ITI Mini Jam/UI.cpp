@@ -1,5 +1,8 @@
 #include "UI.h"
 
+#include "AssetPack.h"
+#include "MemoryTracker.h"
+
 #include <algorithm>
 #include <iostream>
 
@@ -16,22 +19,40 @@ UIButton::UIButton(const Vector2f& size, const Vector2f& pos, Color fill)
 
 bool UIButton::loadTexture(const string& path)
 {
-    if (!tex.loadFromFile(path)) {
+    if (!AssetPack::loadTexture(tex, path)) {
         cerr << "Warning: UIButton failed to load texture: " << path << "\n";
         hasTexture = false;
         return false;
     }
+    MemoryTracker::addTexture(MemCategory::UI, tex);
     rect.setTexture(&tex);
     hasTexture = true;
     return true;
 }
 
+void UIButton::setTextures(const Texture* normal, const Texture* hover)
+{
+    normalTex = normal && normal->getSize().x ? normal : nullptr;
+    hoverTex = hover && hover->getSize().x ? hover : normalTex;
+    if (normalTex) rect.setTexture(hovered ? hoverTex : normalTex);
+    dirty = true;
+}
+
+bool UIButton::setHovered(bool h)
+{
+    if (h == hovered) return false;
+    hovered = h;
+    if (normalTex) rect.setTexture(hovered ? hoverTex : normalTex);
+    dirty = true;
+    return true;
+}
+
 bool UIButton::contains(const Vector2i& mousePos) const
 {
     return rect.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
 }
 
-void UIButton::draw(RenderWindow& window) const { window.draw(rect); }
+void UIButton::draw(DrawTarget& target, const RenderStates& states) const { target.draw(rect, states); }
 
 Slider::Slider(float x_, float y_, float width_, int initial)
 {
@@ -55,7 +76,10 @@ Slider::Slider(float x_, float y_, float width_, int initial)
 }
 
 void Slider::setValue(int v) {
-    value = clamp(v, 0, 100);
+    v = clamp(v, 0, 100);
+    if (v == value) return;
+    value = v;
+    dirty = true;
     barFill.setSize({ (width * value) / 100.f, 8.f });
     knob.setPosition(x + (width * value) / 100.f, y);
 }
@@ -65,7 +89,7 @@ int Slider::getValue() const { return value; }
 bool Slider::handleEvent(const RenderWindow& window, const Event& ev)
 {
     Vector2i mp = Mouse::getPosition(window);
-    bool changed = false;
+    int before = value;
 
     if (ev.type == Event::MouseButtonPressed && ev.mouseButton.button == Mouse::Left) {
         if (knob.getGlobalBounds().contains(static_cast<float>(mp.x), static_cast<float>(mp.y))) {
@@ -74,7 +98,6 @@ bool Slider::handleEvent(const RenderWindow& window, const Event& ev)
         else if (barBg.getGlobalBounds().contains(static_cast<float>(mp.x), static_cast<float>(mp.y))) {
             float rel = clamp((mp.x - x) / width, 0.f, 1.f);
             setValue(static_cast<int>(rel * 100.f));
-            changed = true;
             dragging = true;
         }
     }
@@ -85,17 +108,46 @@ bool Slider::handleEvent(const RenderWindow& window, const Event& ev)
         if (dragging) {
             float rel = clamp((mp.x - x) / width, 0.f, 1.f);
             setValue(static_cast<int>(rel * 100.f));
-            changed = true;
         }
     }
-    return changed;
+    return value != before;
+}
+
+void Slider::draw(DrawTarget& target, const RenderStates& states) const
+{
+    target.draw(barBg, states);
+    target.draw(barFill, states);
+    target.draw(knob, states);
 }
 
-void Slider::draw(RenderWindow& window) const
+void UILabel::setString(const string& s)
 {
-    window.draw(barBg);
-    window.draw(barFill);
-    window.draw(knob);
+    if (!hasValue && s == current) return;
+    current = s;
+    hasValue = false;
+    text.setString(s);
+    dirty = true;
 }
 
+void UILabel::setValue(int v, const char* suffix)
+{
+    if (hasValue && v == currentValue) return;
+    currentValue = v;
+    hasValue = true;
+    current = to_string(v) + suffix;
+    text.setString(current);
+    dirty = true;
+}
 
+bool CachedLayer::create(unsigned width, unsigned height)
+{
+    valid = cache.create(width, height);
+    if (!valid) {
+        cerr << "Warning: can't create UI cache texture, drawing directly\n";
+        return false;
+    }
+    MemoryTracker::addTexture(MemCategory::UI, cache.getTexture());
+    sprite.setTexture(cache.getTexture(), true);
+    dirty = true;
+    return true;
+}
@@ -3,18 +3,33 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 
+#include "RenderStats.h"
+
+// Widgets are retained: setters only touch the drawables when the value
+// actually changes and raise `dirty` when they do. Screens draw their
+// widgets into a CachedLayer and hand it the flags (CachedLayer::track),
+// so the layer is only redrawn on frames where a widget changed.
+
 class UIButton {
 public:
     sf::RectangleShape rect;
     sf::Texture tex;
     bool hasTexture = false;
+    const sf::Texture* normalTex = nullptr;
+    const sf::Texture* hoverTex = nullptr;
+    bool hovered = false;
+    bool dirty = true;
 
     UIButton() = default;
     UIButton(const sf::Vector2f& size, const sf::Vector2f& pos, sf::Color fill = sf::Color(120, 120, 120));
 
     bool loadTexture(const std::string& path);
+    // textures without a size are ignored, a missing hover texture keeps the normal one
+    void setTextures(const sf::Texture* normal, const sf::Texture* hover);
+    // returns true if the hover state changed
+    bool setHovered(bool h);
     bool contains(const sf::Vector2i& mousePos) const;
-    void draw(sf::RenderWindow& window) const;
+    void draw(DrawTarget& target, const sf::RenderStates& states = sf::RenderStates::Default) const;
 };
 
 class Slider {
@@ -25,14 +40,75 @@ public:
     float x = 0.f, y = 0.f, width = 0.f;
     int value = 0;
     bool dragging = false;
+    bool dirty = true;
 
     Slider() = default;
     Slider(float x_, float y_, float width_, int initial = 50);
 
     void setValue(int v);
     int getValue() const;
+    // returns true if the value changed
     bool handleEvent(const sf::RenderWindow& window, const sf::Event& ev);
-    void draw(sf::RenderWindow& window) const;
+    void draw(DrawTarget& target, const sf::RenderStates& states = sf::RenderStates::Default) const;
+};
+
+class UILabel {
+public:
+    sf::Text text;
+    bool dirty = true;
+
+    void setString(const std::string& s);
+    // "<value><suffix>", the text is only rebuilt when the value changes
+    void setValue(int v, const char* suffix = "");
+    void draw(DrawTarget& target, const sf::RenderStates& states = sf::RenderStates::Default) const { target.draw(text, states); }
+
+private:
+    std::string current;
+    int currentValue = 0;
+    bool hasValue = false;
 };
 
+// Caches the static part of a screen in a render texture so it costs one
+// sprite per frame. Falls back to drawing directly if the texture can't
+// be created.
+class CachedLayer {
+public:
+    bool create(unsigned width, unsigned height);
+    void invalidate() { dirty = true; }
+    // invalidates if a widget drawn into the layer changed, and clears its flag
+    void track(bool& widgetDirty)
+    {
+        if (widgetDirty) dirty = true;
+        widgetDirty = false;
+    }
 
+    // drawStatic(DrawTarget&, const sf::RenderStates&) draws the layer in
+    // its own coordinates; it is only called when the cache is stale
+    template<class F>
+    void draw(DrawTarget& target, F drawStatic, sf::Vector2f position = {})
+    {
+        if (!valid) {
+            sf::RenderStates states;
+            states.transform.translate(position.x, position.y);
+            drawStatic(target, states);
+            return;
+        }
+        if (dirty) {
+            DrawTarget cacheTarget(cache);
+            cacheTarget.clear(sf::Color::Transparent);
+            drawStatic(cacheTarget, sf::RenderStates::Default);
+            cache.display();
+            dirty = false;
+        }
+        // the cache holds premultiplied colors, blending it with
+        // BlendAlpha again would darken everything translucent
+        sprite.setPosition(position);
+        target.draw(sprite, sf::RenderStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha)));
+    }
+
+private:
+    sf::RenderTexture cache;
+    sf::Sprite sprite;
+    bool valid = false;
+    bool dirty = true;
+};
@@ -0,0 +1,25 @@
+#include "WorldState.h"
+
+using namespace std;
+
+RewindBuffer::RewindBuffer(size_t capacity)
+    : states(capacity > 0 ? capacity : 1)
+{
+}
+
+WorldState& RewindBuffer::push()
+{
+    WorldState& slot = states[next];
+    next = (next + 1) % states.size();
+    if (count < states.size()) count++;
+    return slot;
+}
+
+bool RewindBuffer::pop(WorldState& out)
+{
+    if (count == 0) return false;
+    next = (next + states.size() - 1) % states.size();
+    count--;
+    out = states[next];
+    return true;
+}
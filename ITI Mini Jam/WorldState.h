@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "PlayerPhysics.h"
+
+// xorshift32, small enough to be saved with the world
+struct Rng {
+    uint32_t state;
+
+    static Rng seeded(uint32_t seed) { return Rng{ seed ? seed : 0x9E3779B9u }; }
+
+    uint32_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    // [0, 1)
+    float uniform() { return (next() >> 8) * (1.f / 16777216.f); }
+};
+
+// Everything the simulation needs to continue from a given tick, as plain
+// data: saving or restoring it is a memcpy. Platforms, obstacles and
+// props are a pure function of levelSeed, so the seed stands in for them.
+struct WorldState {
+    static const int MAX_LAYERS = 8;
+
+    uint32_t levelSeed;
+    uint32_t rng;
+
+    PlayerBody player;
+
+    int animClip, animFrame;
+    float animTime;
+
+    double originX;     // level x of the simulation's x = 0
+    float cameraX, cameraY;
+    float bgOffsets[MAX_LAYERS];
+};
+static_assert(std::is_trivially_copyable_v<WorldState>, "WorldState has to stay memcpy-able");
+
+// The last `capacity` world states in a ring allocated up front, newest
+// out first. Memory stays at capacity * sizeof(WorldState).
+class RewindBuffer {
+public:
+    explicit RewindBuffer(size_t capacity);
+
+    // slot for the newest state, overwrites the oldest when full
+    WorldState& push();
+    // takes the newest state off, false when empty
+    bool pop(WorldState& out);
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return states.size(); }
+
+private:
+    std::vector<WorldState> states;
+    size_t next = 0, count = 0;
+};